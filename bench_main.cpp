@@ -0,0 +1,75 @@
+// This file is part of TAXON.
+// Copyleft 2024-2026, LH_Mouse. All wrongs reserved.
+
+#include "taxon.hpp"
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+
+// This program parses a generated document in all modes, and prints the best time
+// of each. The number of records may be passed as the first argument.
+
+namespace {
+
+template<typename xFunc>
+double
+best_time_ms(xFunc&& func)
+  {
+    double best = 1.0e9;
+    for(int r = 0;  r != 15;  ++r) {
+      auto t0 = ::std::chrono::steady_clock::now();
+      func();
+      auto t1 = ::std::chrono::steady_clock::now();
+      best = ::std::min(best, ::std::chrono::duration<double, ::std::milli>(t1 - t0).count());
+    }
+    return best;
+  }
+
+}  // namespace
+
+int
+main(int argc, char** argv)
+  {
+    long count = (argc > 1) ? ::std::atol(argv[1]) : 200000;
+
+    ::std::string str = "[";
+    for(long k = 0;  k != count;  ++k) {
+      if(k != 0)
+        str += ",";
+
+      str += "{\"id\":" + ::std::to_string(k) + ",\"name\":\"user" + ::std::to_string(k)
+             + "\",\"tags\":[1,2,3,\"x\"],\"ok\":true,\"sub\":{\"a\":1.5,\"b\":null}}";
+    }
+    str += "]";
+
+    ::std::printf("input: %zu bytes\n", str.size());
+
+    ::taxon::Value val;
+    ::std::printf("tree       %8.2f ms\n", best_time_ms(
+        [&] { val.parse(str.data(), str.size());  }));
+
+    ::taxon::Document doc;
+    ::std::printf("document   %8.2f ms\n", best_time_ms(
+        [&] { doc.parse(str.data(), str.size());  }));
+
+    ::taxon::Event_Handler handler;
+    ::std::printf("events     %8.2f ms\n", best_time_ms(
+        [&] { ::taxon::parse_events(handler, str.data(), str.size());  }));
+
+    ::std::printf("validate   %8.2f ms\n", best_time_ms(
+        [&] { ::taxon::validate(str.data(), str.size());  }));
+
+    const ::std::vector<::taxon::V_string> paths = { ::taxon::V_string("/*/name") };
+    ::std::printf("projected  %8.2f ms\n", best_time_ms(
+        [&] { val.parse(str.data(), str.size(), paths);  }));
+
+    ::std::printf("push       %8.2f ms\n", best_time_ms(
+        [&] {
+          ::taxon::Push_Parser push;
+          for(size_t off = 0;  off < str.size();  off += 4096)
+            push.feed(str.data() + off, ::std::min<size_t>(4096, str.size() - off));
+          push.finish();
+        }));
+  }
@@ -0,0 +1,393 @@
+// This file is part of TAXON.
+// Copyleft 2024-2026, LH_Mouse. All wrongs reserved.
+
+#include "taxon.hpp"
+#include <random>
+#include <string>
+#include <vector>
+#include <map>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// This program parses random inputs in all modes, and checks that they agree on
+// errors, offsets and values. The number of inputs may be passed as the first
+// argument, and the seed as the second.
+
+namespace {
+
+::std::mt19937_64 rng;
+
+const char* const atoms[] =
+  {
+    "[", "]", "{", "}", ":", ",", " ", "\t", "\n", "\"", "\\", "\\\"", "\\\\",
+    "\\u0041", "\\ud83d\\ude02", "1", "-2.5e3", "+7", "0.", "1e", "true", "false",
+    "null", "nul", "x", "$", "\"$l:12\"", "\"$h:4142\"", "\"$b:QUJD\"", "\"$t:1\"",
+    "\"$d:inf\"", "\"abc\"", "\xEF\xBB\xBF", "\xC3\xA9", "\xFF", "\x01", "#",
+    "\"k\":", "\"$s:$x\"", "1x", "  ", "\xEF", "\xBF",
+  };
+
+size_t
+random_below(size_t n)
+  {
+    return static_cast<size_t>(rng() % n);
+  }
+
+::std::string
+make_garbage(size_t n)
+  {
+    ::std::string str;
+    for(size_t k = 0;  k != n;  ++k) {
+      if(random_below(4) == 0)
+        str.append(random_below(70), random_below(2) ? ' ' : 'a');
+      str += atoms[random_below(sizeof(atoms) / sizeof(*atoms))];
+    }
+    return str;
+  }
+
+::std::string
+make_value(int depth)
+  {
+    ::std::string ws(random_below(3), ' ');
+    size_t kind = random_below(8);
+    if(depth > 4)
+      kind = kind % 5 + 3;
+
+    ::std::string str;
+    switch(kind)
+      {
+      case 0:
+      case 1:
+        str = "[";
+        for(size_t k = 0, n = random_below(5);  k != n;  ++k)
+          str += (k ? "," : "") + ws + make_value(depth + 1) + ws;
+        return str + "]";
+
+      case 2:
+        str = "{";
+        for(size_t k = 0, n = random_below(5);  k != n;  ++k)
+          str += (k ? ",\"k" : "\"k") + ::std::to_string(k) + ::std::string(random_below(40), 'q')
+                 + "\"" + ws + ":" + make_value(depth + 1);
+        return str + "}";
+
+      case 3:
+        return ::std::to_string(static_cast<long long>(random_below(2000000)) - 1000000);
+
+      case 4:
+        str = "\"";
+        for(size_t k = 0, n = random_below(80);  k != n;  ++k)
+          switch(random_below(10))
+            {
+            case 0:
+              str += "\\\"";
+              break;
+
+            case 1:
+              str += "\\\\";
+              break;
+
+            case 2:
+              str += "\xC3\xA9";
+              break;
+
+            default:
+              str += static_cast<char>('a' + random_below(26));
+              break;
+            }
+        return str + "\"";
+
+      case 5:
+        return random_below(2) ? "true" : "null";
+
+      case 6:
+        return "\"$h:" + ::std::string(random_below(20) * 2, 'a') + "\"";
+
+      default:
+        return "\"$b:" + ::std::string(random_below(20) * 4, 'Q') + "\"";
+      }
+  }
+
+// This handler rebuilds a value from events, so it can be compared with one that
+// has been parsed directly.
+struct Rebuilding_Handler final
+  : ::taxon::Event_Handler
+  {
+    ::taxon::Value root;
+    ::std::vector<::taxon::Value*> stack;
+    ::taxon::Value* pkey = nullptr;
+
+    ::taxon::Value&
+    do_slot()
+      {
+        if(this->stack.empty())
+          return this->root;
+        else if(this->stack.back()->is_array())
+          return this->stack.back()->open_array().emplace_back();
+        else
+          return *(this->pkey);
+      }
+
+    void
+    on_start_array()
+      override
+      {
+        auto& val = this->do_slot();
+        val.open_array();
+        this->stack.push_back(&val);
+      }
+
+    void
+    on_end_array()
+      override
+      {
+        this->stack.pop_back();
+      }
+
+    void
+    on_start_object()
+      override
+      {
+        auto& val = this->do_slot();
+        val.open_object();
+        this->stack.push_back(&val);
+      }
+
+    void
+    on_end_object()
+      override
+      {
+        this->stack.pop_back();
+      }
+
+    void
+    on_key(const char* str, size_t len)
+      override
+      {
+        ::asteria::phcow_string key(::asteria::cow_string(str, len));
+        this->pkey = &(this->stack.back()->open_object().try_emplace(key).first->second);
+      }
+
+    void
+    on_null()
+      override
+      {
+        this->do_slot() = nullptr;
+      }
+
+    void
+    on_boolean(bool value)
+      override
+      {
+        this->do_slot() = value;
+      }
+
+    void
+    on_integer(int64_t value)
+      override
+      {
+        this->do_slot() = value;
+      }
+
+    void
+    on_number(double value)
+      override
+      {
+        this->do_slot() = value;
+      }
+
+    void
+    on_string(const char* str, size_t len)
+      override
+      {
+        this->do_slot() = ::asteria::cow_string(str, len);
+      }
+
+    void
+    on_binary(const unsigned char* data, size_t size)
+      override
+      {
+        this->do_slot() = ::asteria::cow_bstring(data, size);
+      }
+
+    void
+    on_time(::taxon::V_time value)
+      override
+      {
+        this->do_slot() = value;
+      }
+  };
+
+bool
+is_same_value(const ::taxon::Value& lhs, const ::taxon::Value& rhs)
+  {
+    if(lhs.type() != rhs.type())
+      return false;
+
+    if(lhs.is_array()) {
+      if(lhs.as_array().size() != rhs.as_array().size())
+        return false;
+
+      for(size_t k = 0;  k != lhs.as_array().size();  ++k)
+        if(!is_same_value(lhs.as_array().at(k), rhs.as_array().at(k)))
+          return false;
+
+      return true;
+    }
+
+    if(lhs.is_object()) {
+      // Members may be stored in different orders.
+      ::std::map<::std::string, const ::taxon::Value*> members;
+      for(const auto& r : rhs.as_object())
+        members.emplace(::std::string(r.first.data(), r.first.size()), &(r.second));
+
+      if(lhs.as_object().size() != members.size())
+        return false;
+
+      for(const auto& r : lhs.as_object()) {
+        auto it = members.find(::std::string(r.first.data(), r.first.size()));
+        if((it == members.end()) || !is_same_value(r.second, *(it->second)))
+          return false;
+      }
+
+      return true;
+    }
+
+    return lhs.to_string() == rhs.to_string();
+  }
+
+bool
+is_same_error(const ::taxon::Parser_Context& lhs, const ::taxon::Parser_Context& rhs)
+  {
+    if(!lhs.error || !rhs.error)
+      return !lhs.error == !rhs.error;
+
+    return (::std::strcmp(lhs.error, rhs.error) == 0) && (lhs.offset == rhs.offset);
+  }
+
+// Errors in payloads of annotated strings and duplicate keys are only reported
+// by a document when its values are decoded.
+bool
+is_deferred_error(const char* error)
+  {
+    return ::std::strstr(error, "hex") || ::std::strstr(error, "base64")
+           || ::std::strstr(error, "integer") || ::std::strstr(error, "imestamp")
+           || ::std::strstr(error, "Duplicate") || ::std::strstr(error, "range")
+           || ::std::strstr(error, "double");
+  }
+
+}  // namespace
+
+int
+main(int argc, char** argv)
+  {
+    ::setlocale(LC_ALL, "C.UTF-8");
+    long count = (argc > 1) ? ::std::atol(argv[1]) : 20000;
+    rng.seed((argc > 2) ? ::std::strtoull(argv[2], nullptr, 10) : 12345);
+
+    const ::std::vector<::taxon::V_string> all_paths = { ::taxon::V_string("") };
+    long failures = 0;
+
+    for(long it = 0;  it != count;  ++it) {
+      ::std::string str = (it % 2) ? make_garbage(random_below(30)) : make_value(0);
+      if((it % 3 == 0) && !str.empty())
+        str[random_below(str.size())] = "\"\\[]{},: x"[random_below(10)];
+
+      if(it % 7 == 0) {
+        // Nest the input, so the nesting limit may be exceeded.
+        ::std::string prefix;
+        for(size_t k = 0, n = random_below(40);  k != n;  ++k)
+          prefix += random_below(2) ? "[" : "{\"a\":";
+        str = prefix + str;
+      }
+
+      uint32_t bits = 0;
+      if(random_below(4) == 0)
+        bits |= ::taxon::option_bypass_nesting_limit;
+      if(random_below(3) == 0)
+        bits |= ::taxon::option_allow_trailing_commas;
+      auto opts = static_cast<::taxon::Options>(bits);
+
+      ::taxon::Value tree;
+      ::taxon::Parser_Context tctx;
+      tree.parse_with(tctx, str.data(), str.size(), opts);
+
+      auto report = [&](const char* mode, const ::taxon::Parser_Context& ctx) {
+        if(failures ++ < 10)
+          ::std::fprintf(stderr, "MISMATCH (%s) on [%s]\n  tree: %s @ %lld\n  %s: %s @ %lld\n",
+                         mode, str.c_str(), tctx.error ? tctx.error : "ok", static_cast<long long>(tctx.offset),
+                         mode, ctx.error ? ctx.error : "ok", static_cast<long long>(ctx.offset));
+      };
+
+      {
+        // events
+        Rebuilding_Handler handler;
+        ::taxon::Parser_Context ctx;
+        ::taxon::parse_events_with(ctx, handler, str.data(), str.size(), opts);
+        bool dup = tctx.error && (::std::strcmp(tctx.error, "Duplicate key string") == 0);
+        if(!dup && (!is_same_error(tctx, ctx) || (!tctx.error && !is_same_value(tree, handler.root))))
+          report("events", ctx);
+      }
+
+      {
+        // document
+        ::taxon::Document doc;
+        ::taxon::Parser_Context ctx;
+        doc.parse_with(ctx, str.data(), str.size(), opts);
+
+        bool ok;
+        if(!tctx.error)
+          ok = !ctx.error && is_same_value(tree, doc.root().to_value());
+        else if(ctx.error)
+          ok = is_same_error(tctx, ctx)
+               || ((tctx.offset < ctx.offset) && is_deferred_error(tctx.error));
+        else {
+          ok = false;
+          try {
+            doc.root().to_value();
+          }
+          catch(::std::exception& /*stdex*/) {
+            ok = true;
+          }
+        }
+
+        if(!ok)
+          report("document", ctx);
+      }
+
+      {
+        // projected, with a path that selects everything
+        ::taxon::Value val;
+        ::taxon::Parser_Context ctx;
+        val.parse_with(ctx, str.data(), str.size(), all_paths, opts);
+        if(!is_same_error(tctx, ctx) || (!tctx.error && !is_same_value(tree, val)))
+          report("projected", ctx);
+      }
+
+      {
+        // push, with input in random chunks
+        ::taxon::Push_Parser push(opts);
+        size_t step = 1 + random_below(17);
+        for(size_t off = 0;  off < str.size();  off += step) {
+          size_t n = ::std::min(step, str.size() - off);
+          if(push.feed(str.data() + off, n) != n)
+            break;
+        }
+
+        push.finish();
+        const auto& ctx = push.context();
+        if(!is_same_error(tctx, ctx) || (!tctx.error && !is_same_value(tree, push.value())))
+          report("push", ctx);
+      }
+
+      {
+        // validation
+        ::taxon::Parser_Context ctx;
+        ::taxon::validate_with(ctx, str.data(), str.size(), opts);
+        if(!is_same_error(tctx, ctx))
+          report("validate", ctx);
+      }
+    }
+
+    ::std::printf("%ld inputs, %ld mismatches\n", count, failures);
+    return failures != 0;
+  }
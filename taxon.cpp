@@ -6,12 +6,26 @@
 #include <asteria/rocket/tinyfmt.hpp>
 #include <asteria/rocket/ascii_numget.hpp>
 #include <vector>
-#include <map>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <exception>
+#include <system_error>
+#include <mutex>
+#include <condition_variable>
+#include <shared_mutex>
 #include <cmath>
 #include <cstdio>
 #include <climits>
 #include <cfloat>
 #include <cuchar>
+#include <cerrno>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <pthread.h>
+#include <sched.h>
 #if defined __SSE2__
 #include <x86intrin.h>
 #include <xmmintrin.h>
@@ -71,6 +85,131 @@ simd_tzcnt(simd_mask_type m)
   noexcept
   { return ::asteria::tzcnt32(m);  }
 
+ASTERIA_ALWAYS_INLINE
+simd_mask_type
+simd_bitmask(simd_word_type x)
+  noexcept
+  { return static_cast<uint32_t>(_mm256_movemask_epi8(x));  }
+
+// Decodes 32 hexadecimal digits into 16 bytes. If any digit is invalid, false
+// is returned, and the output is indeterminate.
+ASTERIA_ALWAYS_INLINE
+bool
+simd_decode_hex(unsigned char* out, const char* s)
+  noexcept
+  {
+    __m256i t = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s));
+    __m256i d = _mm256_sub_epi8(t, _mm256_set1_epi8('0'));
+    __m256i is_d = _mm256_cmpeq_epi8(_mm256_min_epu8(d, _mm256_set1_epi8(9)), d);
+    __m256i l = _mm256_sub_epi8(_mm256_or_si256(t, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+    __m256i is_l = _mm256_cmpeq_epi8(_mm256_min_epu8(l, _mm256_set1_epi8(5)), l);
+    if(_mm256_movemask_epi8(_mm256_or_si256(is_d, is_l)) != -1)
+      return false;
+
+    // Combine pairs of nibbles, then pack them into bytes.
+    __m256i v = _mm256_blendv_epi8(_mm256_add_epi8(l, _mm256_set1_epi8(10)), d, is_d);
+    v = _mm256_or_si256(_mm256_slli_epi16(_mm256_and_si256(v, _mm256_set1_epi16(0xFF)), 4),
+                        _mm256_srli_epi16(v, 8));
+    v = _mm256_permute4x64_epi64(_mm256_packus_epi16(v, v), 0x08);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm256_castsi256_si128(v));
+    return true;
+  }
+
+// Decodes 32 base64 digits into 24 bytes. If any digit is invalid or is a
+// padding character, false is returned, and the output is indeterminate.
+ASTERIA_ALWAYS_INLINE
+bool
+simd_decode_base64(unsigned char* out, const char* s)
+  noexcept
+  {
+    __m256i t = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s));
+    __m256i u = _mm256_sub_epi8(t, _mm256_set1_epi8('A'));
+    __m256i is_u = _mm256_cmpeq_epi8(_mm256_min_epu8(u, _mm256_set1_epi8(25)), u);
+    __m256i l = _mm256_sub_epi8(t, _mm256_set1_epi8('a'));
+    __m256i is_l = _mm256_cmpeq_epi8(_mm256_min_epu8(l, _mm256_set1_epi8(25)), l);
+    __m256i d = _mm256_sub_epi8(t, _mm256_set1_epi8('0'));
+    __m256i is_d = _mm256_cmpeq_epi8(_mm256_min_epu8(d, _mm256_set1_epi8(9)), d);
+    __m256i is_p = _mm256_cmpeq_epi8(t, _mm256_set1_epi8('+'));
+    __m256i is_s = _mm256_cmpeq_epi8(t, _mm256_set1_epi8('/'));
+    if(_mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(is_u, is_l),
+                                            _mm256_or_si256(is_d, _mm256_or_si256(is_p, is_s)))) != -1)
+      return false;
+
+    __m256i v = _mm256_and_si256(is_u, u);
+    v = _mm256_or_si256(v, _mm256_and_si256(is_l, _mm256_add_epi8(l, _mm256_set1_epi8(26))));
+    v = _mm256_or_si256(v, _mm256_and_si256(is_d, _mm256_add_epi8(d, _mm256_set1_epi8(52))));
+    v = _mm256_or_si256(v, _mm256_and_si256(is_p, _mm256_set1_epi8(62)));
+    v = _mm256_or_si256(v, _mm256_and_si256(is_s, _mm256_set1_epi8(63)));
+
+    // Merge each group of four 6-bit values into a 24-bit value, then pick the
+    // three significant bytes of each in big-endian order.
+    v = _mm256_maddubs_epi16(v, _mm256_set1_epi32(0x01400140));
+    v = _mm256_madd_epi16(v, _mm256_set1_epi32(0x00011000));
+    v = _mm256_shuffle_epi8(v, _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                                                2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+    v = _mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm256_castsi256_si128(v));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(out + 16), _mm256_extracti128_si256(v, 1));
+    return true;
+  }
+
+// Encodes 16 bytes into 32 lowercase hexadecimal digits.
+ASTERIA_ALWAYS_INLINE
+void
+simd_encode_hex(char* out, const unsigned char* s)
+  noexcept
+  {
+    __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s));
+    __m128i h = _mm_and_si128(_mm_srli_epi16(b, 4), _mm_set1_epi8(0x0F));
+    __m128i l = _mm_and_si128(b, _mm_set1_epi8(0x0F));
+    __m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_unpacklo_epi8(h, l)),
+                                        _mm_unpackhi_epi8(h, l), 1);
+
+    // Map 0-9 to `0`-`9` and 10-15 to `a`-`f`.
+    __m256i a = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8(9)),
+                                 _mm256_set1_epi8('a' - '0' - 10));
+    v = _mm256_add_epi8(v, _mm256_add_epi8(a, _mm256_set1_epi8('0')));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), v);
+  }
+
+// Encodes 24 bytes into 32 base64 digits. One more byte after the input is
+// read but does not contribute to the result.
+ASTERIA_ALWAYS_INLINE
+void
+simd_encode_base64(char* out, const unsigned char* s)
+  noexcept
+  {
+    // Load each group of three bytes into a 24-bit value, then spread its four
+    // 6-bit values into separate bytes.
+    __m256i x = _mm256_srli_epi32(_mm256_setr_epi32(
+                   static_cast<int>(::asteria::load_be<uint32_t>(s)),
+                   static_cast<int>(::asteria::load_be<uint32_t>(s + 3)),
+                   static_cast<int>(::asteria::load_be<uint32_t>(s + 6)),
+                   static_cast<int>(::asteria::load_be<uint32_t>(s + 9)),
+                   static_cast<int>(::asteria::load_be<uint32_t>(s + 12)),
+                   static_cast<int>(::asteria::load_be<uint32_t>(s + 15)),
+                   static_cast<int>(::asteria::load_be<uint32_t>(s + 18)),
+                   static_cast<int>(::asteria::load_be<uint32_t>(s + 21))), 8);
+    __m256i v = _mm256_srli_epi32(x, 18);
+    v = _mm256_or_si256(v, _mm256_and_si256(_mm256_srli_epi32(x, 4), _mm256_set1_epi32(0x3F00)));
+    v = _mm256_or_si256(v, _mm256_and_si256(_mm256_slli_epi32(x, 10), _mm256_set1_epi32(0x3F0000)));
+    v = _mm256_or_si256(v, _mm256_slli_epi32(x, 24));
+    v = _mm256_and_si256(v, _mm256_set1_epi32(0x3F3F3F3F));
+
+    // Map 0-25 to `A`-`Z`, 26-51 to `a`-`z`, 52-61 to `0`-`9`, 62 to `+` and
+    // 63 to `/`.
+    __m256i a = _mm256_set1_epi8('A');
+    a = _mm256_add_epi8(a, _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8(25)),
+                                            _mm256_set1_epi8('a' - 26 - 'A')));
+    a = _mm256_add_epi8(a, _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8(51)),
+                                            _mm256_set1_epi8('0' - 52 - 'a' + 26)));
+    a = _mm256_add_epi8(a, _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8(61)),
+                                            _mm256_set1_epi8('+' - 62 - '0' + 52)));
+    a = _mm256_add_epi8(a, _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8(62)),
+                                            _mm256_set1_epi8('/' - 63 - '+' + 62)));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_add_epi8(v, a));
+  }
+
 #elif defined __SSE2__
 
 #define TAXON_HAS_SIMD  1
@@ -113,6 +252,129 @@ simd_tzcnt(simd_mask_type m)
   noexcept
   { return ::asteria::tzcnt32(0x10000 | m);  }
 
+ASTERIA_ALWAYS_INLINE
+simd_mask_type
+simd_bitmask(simd_word_type x)
+  noexcept
+  { return static_cast<uint32_t>(_mm_movemask_epi8(x));  }
+
+// Decodes 16 hexadecimal digits into 8 bytes. If any digit is invalid, false
+// is returned, and the output is indeterminate.
+ASTERIA_ALWAYS_INLINE
+bool
+simd_decode_hex(unsigned char* out, const char* s)
+  noexcept
+  {
+    __m128i t = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s));
+    __m128i d = _mm_sub_epi8(t, _mm_set1_epi8('0'));
+    __m128i is_d = _mm_cmpeq_epi8(_mm_min_epu8(d, _mm_set1_epi8(9)), d);
+    __m128i l = _mm_sub_epi8(_mm_or_si128(t, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+    __m128i is_l = _mm_cmpeq_epi8(_mm_min_epu8(l, _mm_set1_epi8(5)), l);
+    if(_mm_movemask_epi8(_mm_or_si128(is_d, is_l)) != 0xFFFF)
+      return false;
+
+    // Combine pairs of nibbles, then pack them into bytes.
+    __m128i v = _mm_or_si128(_mm_and_si128(is_d, d),
+                             _mm_andnot_si128(is_d, _mm_add_epi8(l, _mm_set1_epi8(10))));
+    v = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(v, _mm_set1_epi16(0xFF)), 4),
+                     _mm_srli_epi16(v, 8));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(v, v));
+    return true;
+  }
+
+// Decodes 16 base64 digits into 12 bytes. If any digit is invalid or is a
+// padding character, false is returned, and the output is indeterminate.
+ASTERIA_ALWAYS_INLINE
+bool
+simd_decode_base64(unsigned char* out, const char* s)
+  noexcept
+  {
+    __m128i t = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s));
+    __m128i u = _mm_sub_epi8(t, _mm_set1_epi8('A'));
+    __m128i is_u = _mm_cmpeq_epi8(_mm_min_epu8(u, _mm_set1_epi8(25)), u);
+    __m128i l = _mm_sub_epi8(t, _mm_set1_epi8('a'));
+    __m128i is_l = _mm_cmpeq_epi8(_mm_min_epu8(l, _mm_set1_epi8(25)), l);
+    __m128i d = _mm_sub_epi8(t, _mm_set1_epi8('0'));
+    __m128i is_d = _mm_cmpeq_epi8(_mm_min_epu8(d, _mm_set1_epi8(9)), d);
+    __m128i is_p = _mm_cmpeq_epi8(t, _mm_set1_epi8('+'));
+    __m128i is_s = _mm_cmpeq_epi8(t, _mm_set1_epi8('/'));
+    if(_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(is_u, is_l),
+                                      _mm_or_si128(is_d, _mm_or_si128(is_p, is_s)))) != 0xFFFF)
+      return false;
+
+    __m128i v = _mm_and_si128(is_u, u);
+    v = _mm_or_si128(v, _mm_and_si128(is_l, _mm_add_epi8(l, _mm_set1_epi8(26))));
+    v = _mm_or_si128(v, _mm_and_si128(is_d, _mm_add_epi8(d, _mm_set1_epi8(52))));
+    v = _mm_or_si128(v, _mm_and_si128(is_p, _mm_set1_epi8(62)));
+    v = _mm_or_si128(v, _mm_and_si128(is_s, _mm_set1_epi8(63)));
+
+    // Merge each group of four 6-bit values into a 24-bit value, and reverse
+    // its three significant bytes.
+    __m128i x = _mm_slli_epi32(_mm_and_si128(v, _mm_set1_epi32(0xFF)), 18);
+    x = _mm_or_si128(x, _mm_slli_epi32(_mm_and_si128(v, _mm_set1_epi32(0xFF00)), 4));
+    x = _mm_or_si128(x, _mm_srli_epi32(_mm_and_si128(v, _mm_set1_epi32(0xFF0000)), 10));
+    x = _mm_or_si128(x, _mm_srli_epi32(v, 24));
+    x = _mm_or_si128(_mm_or_si128(_mm_srli_epi32(x, 16), _mm_and_si128(x, _mm_set1_epi32(0xFF00))),
+                     _mm_slli_epi32(_mm_and_si128(x, _mm_set1_epi32(0xFF)), 16));
+
+    alignas(16) unsigned char temp[16];
+    _mm_store_si128(reinterpret_cast<__m128i*>(temp), x);
+    for(uint32_t k = 0;  k != 4;  ++k)
+      ::std::memcpy(out + k * 3, temp + k * 4, 3);
+    return true;
+  }
+
+// Encodes 8 bytes into 16 lowercase hexadecimal digits.
+ASTERIA_ALWAYS_INLINE
+void
+simd_encode_hex(char* out, const unsigned char* s)
+  noexcept
+  {
+    __m128i b = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(s));
+    __m128i h = _mm_and_si128(_mm_srli_epi16(b, 4), _mm_set1_epi8(0x0F));
+    __m128i l = _mm_and_si128(b, _mm_set1_epi8(0x0F));
+    __m128i v = _mm_unpacklo_epi8(h, l);
+
+    // Map 0-9 to `0`-`9` and 10-15 to `a`-`f`.
+    __m128i a = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(9)), _mm_set1_epi8('a' - '0' - 10));
+    v = _mm_add_epi8(v, _mm_add_epi8(a, _mm_set1_epi8('0')));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), v);
+  }
+
+// Encodes 12 bytes into 16 base64 digits. One more byte after the input is
+// read but does not contribute to the result.
+ASTERIA_ALWAYS_INLINE
+void
+simd_encode_base64(char* out, const unsigned char* s)
+  noexcept
+  {
+    // Load each group of three bytes into a 24-bit value, then spread its four
+    // 6-bit values into separate bytes.
+    __m128i x = _mm_srli_epi32(_mm_setr_epi32(
+                   static_cast<int>(::asteria::load_be<uint32_t>(s)),
+                   static_cast<int>(::asteria::load_be<uint32_t>(s + 3)),
+                   static_cast<int>(::asteria::load_be<uint32_t>(s + 6)),
+                   static_cast<int>(::asteria::load_be<uint32_t>(s + 9))), 8);
+    __m128i v = _mm_srli_epi32(x, 18);
+    v = _mm_or_si128(v, _mm_and_si128(_mm_srli_epi32(x, 4), _mm_set1_epi32(0x3F00)));
+    v = _mm_or_si128(v, _mm_and_si128(_mm_slli_epi32(x, 10), _mm_set1_epi32(0x3F0000)));
+    v = _mm_or_si128(v, _mm_slli_epi32(x, 24));
+    v = _mm_and_si128(v, _mm_set1_epi32(0x3F3F3F3F));
+
+    // Map 0-25 to `A`-`Z`, 26-51 to `a`-`z`, 52-61 to `0`-`9`, 62 to `+` and
+    // 63 to `/`.
+    __m128i a = _mm_set1_epi8('A');
+    a = _mm_add_epi8(a, _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(25)),
+                                      _mm_set1_epi8('a' - 26 - 'A')));
+    a = _mm_add_epi8(a, _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(51)),
+                                      _mm_set1_epi8('0' - 52 - 'a' + 26)));
+    a = _mm_add_epi8(a, _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(61)),
+                                      _mm_set1_epi8('+' - 62 - '0' + 52)));
+    a = _mm_add_epi8(a, _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(62)),
+                                      _mm_set1_epi8('/' - 63 - '+' + 62)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_add_epi8(v, a));
+  }
+
 #elif defined __ARM_NEON
 
 #define TAXON_HAS_SIMD  1
@@ -155,6 +417,128 @@ simd_tzcnt(simd_mask_type m)
   noexcept
   { return ::asteria::tzcnt64(m) >> 2;  }
 
+ASTERIA_ALWAYS_INLINE
+simd_mask_type
+simd_bitmask(simd_word_type x)
+  noexcept
+  {
+    // Compress four bits per byte into one.
+    simd_mask_type m = simd_movmask(x) & 0x1111111111111111;
+    m = (m | m >> 3) & 0x0303030303030303;
+    m = (m | m >> 6) & 0x000F000F000F000F;
+    m = (m | m >> 12) & 0x000000FF000000FF;
+    m = (m | m >> 24) & 0x000000000000FFFF;
+    return m;
+  }
+
+// Decodes 16 hexadecimal digits into 8 bytes. If any digit is invalid, false
+// is returned, and the output is indeterminate.
+ASTERIA_ALWAYS_INLINE
+bool
+simd_decode_hex(unsigned char* out, const char* s)
+  noexcept
+  {
+    uint8x16_t t = vld1q_u8(reinterpret_cast<const uint8_t*>(s));
+    uint8x16_t d = vsubq_u8(t, vdupq_n_u8('0'));
+    uint8x16_t is_d = vcleq_u8(d, vdupq_n_u8(9));
+    uint8x16_t l = vsubq_u8(vorrq_u8(t, vdupq_n_u8(0x20)), vdupq_n_u8('a'));
+    uint8x16_t is_l = vcleq_u8(l, vdupq_n_u8(5));
+    if(simd_movmask(vmvnq_u8(vorrq_u8(is_d, is_l))) != 0)
+      return false;
+
+    // Combine pairs of nibbles, then narrow them into bytes.
+    uint16x8_t v = vreinterpretq_u16_u8(vbslq_u8(is_d, d, vaddq_u8(l, vdupq_n_u8(10))));
+    v = vorrq_u16(vshlq_n_u16(vandq_u16(v, vdupq_n_u16(0xFF)), 4), vshrq_n_u16(v, 8));
+    vst1_u8(out, vmovn_u16(v));
+    return true;
+  }
+
+// Decodes 16 base64 digits into 12 bytes. If any digit is invalid or is a
+// padding character, false is returned, and the output is indeterminate.
+ASTERIA_ALWAYS_INLINE
+bool
+simd_decode_base64(unsigned char* out, const char* s)
+  noexcept
+  {
+    uint8x16_t t = vld1q_u8(reinterpret_cast<const uint8_t*>(s));
+    uint8x16_t u = vsubq_u8(t, vdupq_n_u8('A'));
+    uint8x16_t is_u = vcleq_u8(u, vdupq_n_u8(25));
+    uint8x16_t l = vsubq_u8(t, vdupq_n_u8('a'));
+    uint8x16_t is_l = vcleq_u8(l, vdupq_n_u8(25));
+    uint8x16_t d = vsubq_u8(t, vdupq_n_u8('0'));
+    uint8x16_t is_d = vcleq_u8(d, vdupq_n_u8(9));
+    uint8x16_t is_p = vceqq_u8(t, vdupq_n_u8('+'));
+    uint8x16_t is_s = vceqq_u8(t, vdupq_n_u8('/'));
+    if(simd_movmask(vmvnq_u8(vorrq_u8(vorrq_u8(is_u, is_l), vorrq_u8(is_d, vorrq_u8(is_p, is_s))))) != 0)
+      return false;
+
+    uint8x16_t v = vandq_u8(is_u, u);
+    v = vorrq_u8(v, vandq_u8(is_l, vaddq_u8(l, vdupq_n_u8(26))));
+    v = vorrq_u8(v, vandq_u8(is_d, vaddq_u8(d, vdupq_n_u8(52))));
+    v = vorrq_u8(v, vandq_u8(is_p, vdupq_n_u8(62)));
+    v = vorrq_u8(v, vandq_u8(is_s, vdupq_n_u8(63)));
+
+    // Merge each group of four 6-bit values into a 24-bit value, and reverse
+    // its three significant bytes.
+    uint32x4_t w = vreinterpretq_u32_u8(v);
+    uint32x4_t x = vshlq_n_u32(vandq_u32(w, vdupq_n_u32(0xFF)), 18);
+    x = vorrq_u32(x, vshlq_n_u32(vandq_u32(w, vdupq_n_u32(0xFF00)), 4));
+    x = vorrq_u32(x, vshrq_n_u32(vandq_u32(w, vdupq_n_u32(0xFF0000)), 10));
+    x = vorrq_u32(x, vshrq_n_u32(w, 24));
+    x = vorrq_u32(vorrq_u32(vshrq_n_u32(x, 16), vandq_u32(x, vdupq_n_u32(0xFF00))),
+                  vshlq_n_u32(vandq_u32(x, vdupq_n_u32(0xFF)), 16));
+
+    unsigned char temp[16];
+    vst1q_u8(temp, vreinterpretq_u8_u32(x));
+    for(uint32_t k = 0;  k != 4;  ++k)
+      ::std::memcpy(out + k * 3, temp + k * 4, 3);
+    return true;
+  }
+
+// Encodes 8 bytes into 16 lowercase hexadecimal digits.
+ASTERIA_ALWAYS_INLINE
+void
+simd_encode_hex(char* out, const unsigned char* s)
+  noexcept
+  {
+    uint8x8_t b = vld1_u8(s);
+    uint8x8x2_t z = vzip_u8(vshr_n_u8(b, 4), vand_u8(b, vdup_n_u8(0x0F)));
+    uint8x16_t v = vcombine_u8(z.val[0], z.val[1]);
+
+    // Map 0-9 to `0`-`9` and 10-15 to `a`-`f`.
+    uint8x16_t a = vandq_u8(vcgtq_u8(v, vdupq_n_u8(9)), vdupq_n_u8('a' - '0' - 10));
+    v = vaddq_u8(v, vaddq_u8(a, vdupq_n_u8('0')));
+    vst1q_u8(reinterpret_cast<uint8_t*>(out), v);
+  }
+
+// Encodes 12 bytes into 16 base64 digits. One more byte after the input is
+// read but does not contribute to the result.
+ASTERIA_ALWAYS_INLINE
+void
+simd_encode_base64(char* out, const unsigned char* s)
+  noexcept
+  {
+    // Load each group of three bytes into a 24-bit value, then spread its four
+    // 6-bit values into separate bytes.
+    const uint32_t words[4] = { ::asteria::load_be<uint32_t>(s), ::asteria::load_be<uint32_t>(s + 3),
+                                ::asteria::load_be<uint32_t>(s + 6), ::asteria::load_be<uint32_t>(s + 9) };
+    uint32x4_t x = vshrq_n_u32(vld1q_u32(words), 8);
+    uint32x4_t w = vshrq_n_u32(x, 18);
+    w = vorrq_u32(w, vandq_u32(vshrq_n_u32(x, 4), vdupq_n_u32(0x3F00)));
+    w = vorrq_u32(w, vandq_u32(vshlq_n_u32(x, 10), vdupq_n_u32(0x3F0000)));
+    w = vorrq_u32(w, vshlq_n_u32(x, 24));
+    uint8x16_t v = vandq_u8(vreinterpretq_u8_u32(w), vdupq_n_u8(0x3F));
+
+    // Map 0-25 to `A`-`Z`, 26-51 to `a`-`z`, 52-61 to `0`-`9`, 62 to `+` and
+    // 63 to `/`.
+    uint8x16_t a = vdupq_n_u8('A');
+    a = vaddq_u8(a, vandq_u8(vcgtq_u8(v, vdupq_n_u8(25)), vdupq_n_u8(static_cast<uint8_t>('a' - 26 - 'A'))));
+    a = vaddq_u8(a, vandq_u8(vcgtq_u8(v, vdupq_n_u8(51)), vdupq_n_u8(static_cast<uint8_t>('0' - 52 - 'a' + 26))));
+    a = vaddq_u8(a, vandq_u8(vcgtq_u8(v, vdupq_n_u8(61)), vdupq_n_u8(static_cast<uint8_t>('+' - 62 - '0' + 52))));
+    a = vaddq_u8(a, vandq_u8(vcgtq_u8(v, vdupq_n_u8(62)), vdupq_n_u8(static_cast<uint8_t>('/' - 63 - '+' + 62))));
+    vst1q_u8(reinterpret_cast<uint8_t*>(out), vaddq_u8(v, a));
+  }
+
 #endif  // SIMD
 
 constexpr ASTERIA_ALWAYS_INLINE
@@ -184,21 +568,29 @@ do_err(Parser_Context& ctx, const char* error)
     ctx.error = error;
   }
 
+struct Structural_Index;
+
 struct Memory_Source
   {
     const char* bptr;
     const char* sptr;
     const char* eptr;
 
+    // optional structural index, which is built in windows; `[iptr,ieptr)` is
+    // the part that has been built but not consumed; see `do_fill_index()`
+    Structural_Index* index;
+    const uint32_t* iptr;
+    const uint32_t* ieptr;
+
     constexpr
     Memory_Source()
       noexcept
-      : bptr(), sptr(), eptr()  { }
+      : bptr(), sptr(), eptr(), index(), iptr(), ieptr()  { }
 
     constexpr
     Memory_Source(const char* s, size_t n)
       noexcept
-      : bptr(s), sptr(s), eptr(s + n)  { }
+      : bptr(s), sptr(s), eptr(s + n), index(), iptr(), ieptr()  { }
 
     int
     getc()
@@ -232,1411 +624,5770 @@ struct Memory_Source
       }
   };
 
-struct Unified_Source
+// This is a source that reads a file in blocks, so the fast paths for memory
+// sources also apply to it. Bytes that have been read but not consumed are
+// returned by seeking backwards upon destruction, which fails silently if the
+// file is not seekable.
+struct Buffered_Source
+  : Memory_Source
   {
-    ::asteria::tinyfmt* fmt = nullptr;
-    Memory_Source* mem = nullptr;
+    static constexpr size_t block_size = 128 * 1024;
+
     ::std::FILE* fp = nullptr;
+    int fd = -1;
+    int64_t boff = 0;  // stream offset of `bptr`
+    ::std::unique_ptr<char[]> buf;
 
-    Unified_Source(::asteria::tinyfmt* b)
-      noexcept
-      : fmt(b)  { }
+    explicit
+    Buffered_Source(::std::FILE* f)
+      : fp(f), buf(new char[block_size])
+      {
+        this->boff = ::std::max<int64_t>(::ftello(f), 0);
+        this->bptr = this->sptr = this->eptr = this->buf.get();
+      }
+
+    explicit
+    Buffered_Source(int d)
+      : fd(d), buf(new char[block_size])
+      {
+        this->boff = ::std::max<int64_t>(::lseek(d, 0, SEEK_CUR), 0);
+        this->bptr = this->sptr = this->eptr = this->buf.get();
+      }
+
+    Buffered_Source(const Buffered_Source&) = delete;
+    Buffered_Source& operator=(const Buffered_Source&) = delete;
+
+    ~Buffered_Source()
+      {
+        off_t n = this->eptr - this->sptr;
+        if(n == 0)
+          return;
+
+        if(this->fp)
+          ::fseeko(this->fp, -n, SEEK_CUR);
+        else
+          ::lseek(this->fd, -n, SEEK_CUR);
+      }
+
+    bool
+    do_refill()
+      {
+        // All data in the buffer have been consumed, so discard them. Pointers
+        // into the buffer are invalidated.
+        this->boff += this->eptr - this->bptr;
+        ::ssize_t r;
+        if(this->fp)
+          r = static_cast<::ssize_t>(::fread(this->buf.get(), 1, block_size, this->fp));
+        else {
+          do
+            r = ::read(this->fd, this->buf.get(), block_size);
+          while((r < 0) && (errno == EINTR));
+        }
+
+        this->sptr = this->bptr;
+        this->eptr = this->bptr + ::std::max<::ssize_t>(r, 0);
+        return r > 0;
+      }
+
+    int
+    getc()
+      {
+        int r = -1;
+        if((this->sptr != this->eptr) || this->do_refill()) {
+          r = static_cast<unsigned char>(*(this->sptr));
+          this->sptr ++;
+        }
+        return r;
+      }
+
+    size_t
+    getn(char* s, size_t n)
+      {
+        size_t r = 0;
+        while((r != n) && ((this->sptr != this->eptr) || this->do_refill())) {
+          size_t k = ::std::min(static_cast<size_t>(this->eptr - this->sptr), n - r);
+          ::memcpy(s + r, this->sptr, k);
+          this->sptr += k;
+          r += k;
+        }
+        return r;
+      }
+
+    int64_t
+    tell()
+      const noexcept
+      {
+        return this->boff + (this->sptr - this->bptr);
+      }
+  };
+
+// This is a chunk of a stream, which is parsed separately by `Push_Parser`.
+// Offsets are relative to the beginning of the stream.
+struct Chunk_Source
+  : Memory_Source
+  {
+    int64_t boff;  // stream offset of `bptr`
 
-    Unified_Source(Memory_Source* m)
+    Chunk_Source(const char* s, size_t n, int64_t off)
       noexcept
-      : mem(m)  { }
+      : Memory_Source(s, n), boff(off)  { }
+
+    int64_t
+    tell()
+      const noexcept
+      {
+        return this->boff + (this->sptr - this->bptr);
+      }
+  };
+
+struct File_Source
+  {
+    ::std::FILE* fp;
 
-    Unified_Source(::std::FILE* f)
+    explicit
+    File_Source(::std::FILE* f)
       noexcept
       : fp(f)  { }
 
     int
     getc()
-      const
       {
-        if(this->mem)
-          return this->mem->getc();
-        else if(this->fp)
-          return ::fgetc(this->fp);
-        else
-          return this->fmt->getc();
+        return ::fgetc(this->fp);
       }
 
     size_t
     getn(char* s, size_t n)
-      const
       {
-        if(this->mem)
-          return this->mem->getn(s, n);
-        else if(this->fp)
-          return ::fread(s, 1, n, this->fp);
-        else
-          return this->fmt->getn(s, n);
+        return ::fread(s, 1, n, this->fp);
       }
 
     int64_t
     tell()
       const
       {
-        if(this->mem)
-          return this->mem->tell();
-        else if(this->fp)
-          return ::ftello(this->fp);
-        else
-          return this->fmt->tell();
+        return ::ftello(this->fp);
       }
   };
 
-struct Unified_Sink
+struct Tinyfmt_Source
   {
-    ::asteria::tinyfmt* fmt = nullptr;
-    ::asteria::cow_string* str = nullptr;
-    ::asteria::linear_buffer* ln = nullptr;
-    ::std::FILE* fp = nullptr;
+    ::asteria::tinyfmt* fmt;
 
-    Unified_Sink(::asteria::tinyfmt* b)
+    explicit
+    Tinyfmt_Source(::asteria::tinyfmt& b)
       noexcept
-      : fmt(b)  { }
+      : fmt(&b)  { }
 
-    Unified_Sink(::asteria::cow_string* s)
-      noexcept
-      : str(s)  { }
+    int
+    getc()
+      {
+        return this->fmt->getc();
+      }
+
+    size_t
+    getn(char* s, size_t n)
+      {
+        return this->fmt->getn(s, n);
+      }
+
+    int64_t
+    tell()
+      const
+      {
+        return this->fmt->tell();
+      }
+  };
 
-    Unified_Sink(::asteria::linear_buffer* l)
+struct User_Source
+  {
+    const Source_Ref* ref;
+
+    explicit
+    User_Source(const Source_Ref& r)
       noexcept
-      : ln(l)  { }
+      : ref(&r)  { }
+
+    int
+    getc()
+      {
+        return this->ref->fn_getc(this->ref->obj);
+      }
+
+    size_t
+    getn(char* s, size_t n)
+      {
+        return this->ref->fn_getn(this->ref->obj, s, n);
+      }
+
+    int64_t
+    tell()
+      const
+      {
+        return this->ref->fn_tell(this->ref->obj);
+      }
+  };
+
+// Sources are concrete types, so the parser is instantiated for each of them.
+// Memory sources (including buffered ones) and standard files have fast paths
+// in `do_token()`.
+template<typename xSource>
+constexpr bool is_memory_source = ::std::is_base_of<Memory_Source, xSource>::value;
 
-    Unified_Sink(::std::FILE* f)
+template<typename xSource>
+constexpr bool is_file_source = ::std::is_same<xSource, File_Source>::value;
+
+struct String_Sink
+  {
+    ::asteria::cow_string* str;
+
+    explicit
+    String_Sink(::asteria::cow_string& s)
       noexcept
-      : fp(f)  { }
+      : str(&s)  { }
 
     void
     putc(char c)
       const
       {
-        if(this->str)
-          this->str->push_back(c);
-        else if(this->ln)
-          this->ln->putc(c);
-        else if(this->fp)
-          ::fputc(c, this->fp);
-        else
-          this->fmt->putc(c);
+        this->str->push_back(c);
       }
 
     void
     putn(const char* s, size_t n)
       const
       {
-        if(this->str)
-          this->str->append(s, n);
-        else if(this->ln)
-          this->ln->putn(s, n);
-        else if(this->fp)
-          ::fwrite(s, 1, n, this->fp);
-        else
-          this->fmt->putn(s, n);
+        this->str->append(s, n);
       }
   };
 
-ASTERIA_FLATTEN
-const ::asteria::phcow_string&
-do_intern_string(::std::multimap<size_t, ::asteria::phcow_string>& pool, const char* str, size_t len)
+struct Buffer_Sink
   {
-    size_t hval = ::asteria::phcow_string::hasher()(str, len);
-    auto range = pool.equal_range(hval);
+    ::asteria::linear_buffer* ln;
 
-    // String already exists?
-    for(auto it = range.first;  it != range.second;  ++it)
-      if((it->second.size() == len) && ::asteria::xmemeq(it->second.data(), str, len))
-        return it->second;
+    explicit
+    Buffer_Sink(::asteria::linear_buffer& l)
+      noexcept
+      : ln(&l)  { }
 
-    // No. Allocate a new one, while keeping the pool sorted.
-    auto it = pool.emplace(hval, ::asteria::cow_string(str, len));
-    ASTERIA_ASSERT(it->second.rdhash() == hval);
-    return it->second;
-  }
+    void
+    putc(char c)
+      const
+      {
+        this->ln->putc(c);
+      }
 
-void
-do_load_next(Parser_Context& ctx, const Unified_Source& usrc)
+    void
+    putn(const char* s, size_t n)
+      const
+      {
+        this->ln->putn(s, n);
+      }
+  };
+
+struct File_Sink
   {
-    ctx.c = usrc.getc();
-    if(ctx.c < 0) {
-      ctx.eof = true;
-      return do_err(ctx, nullptr);
-    }
+    ::std::FILE* fp;
 
-    if(is_within(ctx.c, 0x80, 0xBF))
-      return do_err(ctx, "Invalid UTF-8 byte");
-    else if(ASTERIA_UNEXPECT(ctx.c > 0x7F)) {
-      // Parse a multibyte Unicode character.
-      uint32_t u8len = ::asteria::lzcnt32((static_cast<uint32_t>(ctx.c) << 24) ^ UINT32_MAX);
-      ctx.c &= (1 << (7 - u8len)) - 1;
+    explicit
+    File_Sink(::std::FILE* f)
+      noexcept
+      : fp(f)  { }
 
-      char tbytes[4];
-      if(usrc.getn(tbytes, u8len - 1) != u8len - 1) {
-        ctx.eof = true;
-        return do_err(ctx, "Incomplete UTF-8 sequence");
+    void
+    putc(char c)
+      const
+      {
+        ::fputc(c, this->fp);
       }
 
-      for(uint32_t k = 0;  k != u8len - 1;  ++k)
-        if(!is_within(static_cast<uint8_t>(tbytes[k]), 0x80, 0xBF))
-          return do_err(ctx, "Invalid UTF-8 sequence");
-        else {
-          ctx.c <<= 6;
-          ctx.c |= tbytes[k] & 0x3F;
-        }
-
-      if((ctx.c < 0x80)  // overlong
-          || (ctx.c < (1 << (u8len * 5 - 4)))  // overlong
-          || is_within(ctx.c, 0xD800, 0xDFFF)  // surrogates
-          || (ctx.c > 0x10FFFF))
-        return do_err(ctx, "Invalid Unicode character");
-    }
-  }
+    void
+    putn(const char* s, size_t n)
+      const
+      {
+        ::fwrite(s, 1, n, this->fp);
+      }
+  };
 
-ASTERIA_FLATTEN
-void
-do_token(::asteria::cow_string& token, Parser_Context& ctx, const Unified_Source& usrc)
+struct Tinyfmt_Sink
   {
-    // Clear the current token and skip whitespace.
-    ctx.error = nullptr;
-    token.clear();
+    ::asteria::tinyfmt* fmt;
 
-    if(ctx.c < 0) {
-      ctx.saved_offset = usrc.tell();
-      do_load_next(ctx, usrc);
-      if(ctx.c < 0)
-        return;
+    explicit
+    Tinyfmt_Sink(::asteria::tinyfmt& b)
+      noexcept
+      : fmt(&b)  { }
 
-      // Skip the UTF-8 BOM, if any.
-      if((ctx.saved_offset == 0) && (ctx.c == 0xFEFF)) {
-        ctx.saved_offset = usrc.tell();
-        do_load_next(ctx, usrc);
-        if(ctx.c < 0)
-          return;
+    void
+    putc(char c)
+      const
+      {
+        this->fmt->putc(c);
       }
-    }
 
-    while(is_any(ctx.c, ' ', '\t', '\r', '\n')) {
-      if(usrc.mem) {
-        auto tptr = usrc.mem->sptr;
-        while(usrc.mem->eptr != tptr) {
-          if(!is_any(*tptr, ' ', '\t', '\r', '\n'))
-            goto break_found_;
-          ++ tptr;
+    void
+    putn(const char* s, size_t n)
+      const
+      {
+        this->fmt->putn(s, n);
+      }
+  };
 
-#ifdef TAXON_HAS_SIMD
-          while(usrc.mem->eptr - tptr >= static_cast<ptrdiff_t>(sizeof(simd_word_type))) {
-            simd_word_type t = simd_load(tptr);
-            simd_mask_type mask = simd_movmask(simd_bcast(0xFF))
-                                  ^ (simd_movmask(simd_cmpeq(t, simd_bcast(' ')))
-                                     | simd_movmask(simd_cmpeq(t, simd_bcast('\t')))
-                                     | simd_movmask(simd_cmpeq(t, simd_bcast('\r')))
-                                     | simd_movmask(simd_cmpeq(t, simd_bcast('\n'))));
-            tptr += simd_tzcnt(mask);
-            if(mask != 0)
-              goto break_found_;
-          }
-#endif
-        }
+struct User_Sink
+  {
+    const Sink_Ref* ref;
 
-  break_found_:
-        usrc.mem->sptr = tptr;
+    explicit
+    User_Sink(const Sink_Ref& r)
+      noexcept
+      : ref(&r)  { }
+
+    void
+    putc(char c)
+      const
+      {
+        this->ref->fn_putc(this->ref->obj, c);
       }
-      else if(usrc.fp) {
-        (void)! ::fscanf(usrc.fp, "%*[ \t\r\n]");
+
+    void
+    putn(const char* s, size_t n)
+      const
+      {
+        this->ref->fn_putn(this->ref->obj, s, n);
       }
+  };
 
-      ctx.saved_offset = usrc.tell();
-      do_load_next(ctx, usrc);
-      if(ctx.c < 0)
-        return;
-    }
+// This is a token that has been returned by `do_token()`. For memory sources, a
+// token that requires no decoding refers to the source directly; otherwise, it
+// is stored into `str`, whose storage is reused across tokens.
+struct Parser_Token
+  {
+    ::asteria::cow_string str;
+    const char* vptr = nullptr;
+    size_t vlen = 0;
 
-    switch(ctx.c)
+    void
+    clear()
+      noexcept
       {
-      case '[':
-      case ']':
-      case '{':
-      case '}':
-      case ':':
-      case ',':
-        // Take each of these characters as a single token; do not attempt to get
-        // the next character, as some of these tokens may terminate the input,
-        // and the stream may be blocking but we can't really know whether there
-        // are more data.
-        token.push_back(static_cast<char>(ctx.c));
-        ctx.c = -1;
-        break;
+        this->str.clear();
+        this->vptr = nullptr;
+        this->vlen = 0;
+      }
 
-      case '_':
-      case '$':
-      case 'A' ... 'Z':
-      case 'a' ... 'z':
-        // Take an identifier. As in JavaScript, we accept dollar signs in
-        // identifiers as an extension.
-        do {
-          token.push_back(static_cast<char>(ctx.c));
-          do_load_next(ctx, usrc);
-        }
-        while(is_any(ctx.c, '_', '$') || is_within(ctx.c, 'A', 'Z')
-              || is_within(ctx.c, 'a', 'z') || is_within(ctx.c, '0', '9'));
+    void
+    push_back(char c)
+      {
+        this->str.push_back(c);
+      }
 
-        // If the end of input has been reached, `ctx.error` may be set. We will
-        // not return an error, so clear it.
-        ASTERIA_ASSERT(token.size() != 0);
-        ctx.error = nullptr;
-        ctx.eof = false;
-        break;
+    void
+    append(const char* s, size_t n)
+      {
+        this->str.append(s, n);
+      }
 
-      case '+':
-      case '-':
-        // Take a floating-point number. Strictly, JSON doesn't allow plus signs
-        // or leading zeroes, but we accept them as extensions.
-        token.push_back(static_cast<char>(ctx.c));
-        do_load_next(ctx, usrc);
+    void
+    set_view(const char* s, size_t n)
+      noexcept
+      {
+        ASTERIA_ASSERT(this->str.empty());
+        this->vptr = s;
+        this->vlen = n;
+      }
 
-        if(!is_within(ctx.c, '0', '9'))
-          return do_err(ctx, "Invalid number");
+    const char*
+    data()
+      const noexcept
+      {
+        return this->vptr ? this->vptr : this->str.data();
+      }
 
-        do {  // fallthrough
-      case '0' ... '9':
-          token.push_back(static_cast<char>(ctx.c));
-          do_load_next(ctx, usrc);
-        } while(is_within(ctx.c, '0', '9'));
+    size_t
+    size()
+      const noexcept
+      {
+        return this->vptr ? this->vlen : this->str.size();
+      }
 
-        if(ctx.c == '.') {
-          token.push_back(static_cast<char>(ctx.c));
-          do_load_next(ctx, usrc);
+    bool
+    empty()
+      const noexcept
+      {
+        return this->size() == 0;
+      }
 
-          if(!is_within(ctx.c, '0', '9'))
-            return do_err(ctx, "Invalid number");
+    bool
+    equals(const char* s, size_t n)
+      const noexcept
+      {
+        return (this->size() == n) && ::asteria::xmemeq(this->data(), s, n);
+      }
 
-          do {
-            token.push_back(static_cast<char>(ctx.c));
-            do_load_next(ctx, usrc);
-          } while(is_within(ctx.c, '0', '9'));
-        }
+    char
+    operator[](size_t k)
+      const noexcept
+      {
+        return this->data()[k];
+      }
+  };
 
-        if(is_any(ctx.c, 'e', 'E')) {
-          token.push_back(static_cast<char>(ctx.c));
-          do_load_next(ctx, usrc);
+// This is a pool of interned strings. It is a hash table with open addressing
+// and linear probing. Strings are stored contiguously in the order they were
+// added, and the table holds their hash values and positions, so a lookup only
+// touches a few cache lines.
+struct Key_Pool
+  {
+    struct xEntry
+      {
+        size_t hval;
+        size_t pos;  // index of the string plus one, or zero if unused
+      };
 
-          if(is_any(ctx.c, '+', '-')) {
-            token.push_back(static_cast<char>(ctx.c));
-            do_load_next(ctx, usrc);
-          }
+    ::std::vector<xEntry> table;  // size is zero or a power of two
+    ::std::vector<::asteria::phcow_string> strs;
 
-          if(!is_within(ctx.c, '0', '9'))
-            return do_err(ctx, "Invalid number");
+    size_t
+    size()
+      const noexcept
+      {
+        return this->strs.size();
+      }
 
-          do {
-            token.push_back(static_cast<char>(ctx.c));
-            do_load_next(ctx, usrc);
-          } while(is_within(ctx.c, '0', '9'));
+    void
+    clear()
+      noexcept
+      {
+        this->strs.clear();
+        ::std::fill(this->table.begin(), this->table.end(), xEntry());
+      }
+
+    void
+    do_rehash(size_t cap)
+      {
+        ASTERIA_ASSERT((cap & (cap - 1)) == 0);
+        this->table.assign(cap, xEntry());
+        for(size_t k = 0;  k != this->strs.size();  ++k) {
+          size_t i = this->strs[k].rdhash() & (cap - 1);
+          while(this->table[i].pos != 0)
+            i = (i + 1) & (cap - 1);
+
+          this->table[i].hval = this->strs[k].rdhash();
+          this->table[i].pos = k + 1;
         }
+      }
 
-        // If the end of input has been reached, `ctx.error` may be set. We will
-        // not return an error, so clear it.
-        ASTERIA_ASSERT(token.size() != 0);
-        ctx.error = nullptr;
-        ctx.eof = false;
-        break;
+    void
+    reserve(size_t n)
+      {
+        // Keep the load factor no more than one half.
+        if(n * 2 <= this->table.size())
+          return;
 
-      case '\"':
-        // Take a double-quoted string. When stored in `token`, it shall start
-        // with a double-quote character, followed by the decoded string. No
-        // terminating double-quote character is appended.
-        token.push_back('\"');
-        for(;;) {
-          if(usrc.mem) {
-            auto tptr = usrc.mem->sptr;
-            while(usrc.mem->eptr != tptr) {
-              if(is_any(*tptr, '\\', '\"') || !is_within(*tptr, 0x20, 0x7E))
-                goto escape_found_;
-              ++ tptr;
+        size_t cap = 16;
+        while(cap < n * 2)
+          cap *= 2;
 
-#ifdef TAXON_HAS_SIMD
-              while(usrc.mem->eptr - tptr >= static_cast<ptrdiff_t>(sizeof(simd_word_type))) {
-                simd_word_type t = simd_load(tptr);
-                simd_mask_type mask = simd_movmask(simd_cmpeq(t, simd_bcast('\\')))
-                                      | simd_movmask(simd_cmpeq(t, simd_bcast('\"')))
-                                      | simd_movmask(simd_cmpgt(simd_bcast(0x20), t))
-                                      | simd_movmask(simd_cmpgt(t, simd_bcast(0x7E)));
-                tptr += simd_tzcnt(mask);
-                if(mask != 0)
-                  goto escape_found_;
-              }
-#endif
-            }
+        this->strs.reserve(n);
+        this->do_rehash(cap);
+      }
 
-  escape_found_:
-            if(tptr != usrc.mem->sptr)
-              token.append(usrc.mem->sptr, static_cast<size_t>(tptr - usrc.mem->sptr));
-            usrc.mem->sptr = tptr;
-          }
-          else if(usrc.fp) {
-            char temp[256];
-            size_t len;
-            while(::fscanf(usrc.fp, "%255[]-~ !#-[]%zn", temp, &len) == 1) {
-              token.append(temp, len);
-              if(len < 256)
-                break;
-            }
+    const ::asteria::phcow_string*
+    find(size_t hval, const char* str, size_t len)
+      const noexcept
+      {
+        if(this->table.empty())
+          return nullptr;
+
+        size_t mask = this->table.size() - 1;
+        for(size_t i = hval & mask;  this->table[i].pos != 0;  i = (i + 1) & mask)
+          if(this->table[i].hval == hval) {
+            const auto& sref = this->strs[this->table[i].pos - 1];
+            if((sref.size() == len) && ::asteria::xmemeq(sref.data(), str, len))
+              return &sref;
           }
 
-          do_load_next(ctx, usrc);
-          if(ctx.eof)
-            return do_err(ctx, "String not terminated properly");
-          else if((ctx.c <= 0x1F) || (ctx.c == 0x7F))
-            return do_err(ctx, "Control character not allowed in string");
-          else if(ctx.c == '\"')
-            break;
-
-          if(ASTERIA_UNEXPECT(ctx.c == '\\')) {
-            // Read an escape sequence.
-            int next = usrc.getc();
-            if(next < 0) {
-              ctx.eof = true;
-              return do_err(ctx, "Incomplete escape sequence");
-            }
+        return nullptr;
+      }
 
-            switch(next)
-              {
-              case '\\':
-              case '\"':
-              case '/':
-                ctx.c = next;
-                break;
+    // Adds a string which does not exist. The result is invalidated by the next
+    // call to this function.
+    const ::asteria::phcow_string&
+    insert(const ::asteria::phcow_string& str)
+      {
+        if(this->strs.size() * 2 >= this->table.size())
+          this->do_rehash(::std::max<size_t>(this->table.size() * 2, 16));
+
+        size_t mask = this->table.size() - 1;
+        size_t i = str.rdhash() & mask;
+        while(this->table[i].pos != 0)
+          i = (i + 1) & mask;
+
+        this->strs.push_back(str);
+        this->table[i].hval = str.rdhash();
+        this->table[i].pos = this->strs.size();
+        return this->strs.back();
+      }
+  };
 
-              case 'b':
-                ctx.c = '\b';
-                break;
+ASTERIA_FLATTEN
+const ::asteria::phcow_string&
+do_intern_string(Key_Pool& pool, Key_Dictionary* dict, const char* str, size_t len)
+  {
+    size_t hval = ::asteria::phcow_string::hasher()(str, len);
 
-              case 'f':
-                ctx.c = '\f';
-                break;
+    // String already exists?
+    if(auto ptr = pool.find(hval, str, len))
+      return *ptr;
+
+    // No. Get it from the dictionary, or allocate a new one.
+    auto& sref = dict ? pool.insert(dict->intern(str, len))
+                      : pool.insert(::asteria::cow_string(str, len));
+    ASTERIA_ASSERT(sref.rdhash() == hval);
+    return sref;
+  }
 
-              case 'n':
-                ctx.c = '\n';
-                break;
+// Gets the key of a member of an object. Objects at the same level of nesting,
+// such as records in an array, usually have the same keys in the same order,
+// so `shape` holds keys of the previous object, and the key at `index` is tried
+// first. If it doesn't match, `shape` is updated with keys of this object.
+ASTERIA_FLATTEN
+const ::asteria::phcow_string&
+do_shape_key(::std::vector<::asteria::phcow_string>& shape, size_t index, Key_Pool& pool,
+             Key_Dictionary* dict, const char* str, size_t len)
+  {
+    if(index < shape.size()) {
+      const auto& pred = shape[index];
+      if((pred.size() == len) && ::asteria::xmemeq(pred.data(), str, len))
+        return pred;
 
-              case 'r':
-                ctx.c = '\r';
-                break;
+      shape.erase(shape.begin() + static_cast<ptrdiff_t>(index), shape.end());
+    }
 
-              case 't':
-                ctx.c = '\t';
-                break;
+    return shape.emplace_back(do_intern_string(pool, dict, str, len));
+  }
 
-              case 'u':
-                {
-                  // Read the first UTF-16 code unit.
-                  char temp[16];
-                  if(usrc.getn(temp, 4) != 4)
-                    return do_err(ctx, "Invalid escape sequence");
+// This is the first stage of the parser for memory sources. Characters are
+// classified 64 bytes at a time, then the offsets of all structural characters
+// (brackets, braces, colons and commas) outside strings, all unescaped double
+// quotes, and the first characters of all other tokens are stored into an index
+// in ascending order. Whitespace is never indexed, so the second stage may jump
+// from one token to the next directly. The index is not validated; malformed
+// input is diagnosed by the second stage, before it could reach any entry that
+// has been misclassified.
+struct Block_Masks
+  {
+    uint64_t bs;  // backslashes
+    uint64_t qt;  // double quotes
+    uint64_t ws;  // whitespace
+    uint64_t op;  // brackets, braces, colons and commas
+  };
 
-                  ctx.c = 0;
-                  for(uint32_t k = 0;  k != 4;  ++k) {
-                    ctx.c <<= 4;
-                    int c = static_cast<uint8_t>(temp[k]);
-                    if(is_within(c, '0', '9'))
-                      ctx.c |= c - '0';
-                    else if(is_within(c, 'A', 'F'))
-                      ctx.c |= c - 'A' + 10;
-                    else if(is_within(c, 'a', 'f'))
-                      ctx.c |= c - 'a' + 10;
-                    else
-                      return do_err(ctx, "Invalid hexadecimal digit");
-                  }
+ASTERIA_ALWAYS_INLINE
+void
+do_classify_block(Block_Masks& bm, const char* s)
+  {
+    bm.bs = 0;
+    bm.qt = 0;
+    bm.ws = 0;
+    bm.op = 0;
 
-                  if(is_within(ctx.c, 0xDC00, 0xDFFF))
-                    return do_err(ctx, "Dangling UTF-16 trailing surrogate");
-                  else if(is_within(ctx.c, 0xD800, 0xDBFF)) {
-                    // The character was a UTF-16 leading surrogate. Now look for
-                    // a trailing one, which must be another `\uXXXX` sequence.
-                    if(usrc.getn(temp, 6) != 6)
-                      return do_err(ctx, "Missing UTF-16 trailing surrogate");
+#ifdef TAXON_HAS_SIMD
+    for(uint32_t k = 0;  k != 64;  k += sizeof(simd_word_type)) {
+      simd_word_type t = simd_load(s + k);
+      bm.bs |= static_cast<uint64_t>(simd_bitmask(simd_cmpeq(t, simd_bcast('\\')))) << k;
+      bm.qt |= static_cast<uint64_t>(simd_bitmask(simd_cmpeq(t, simd_bcast('\"')))) << k;
+      bm.ws |= static_cast<uint64_t>(simd_bitmask(simd_cmpeq(t, simd_bcast(' ')))
+                                     | simd_bitmask(simd_cmpeq(t, simd_bcast('\t')))
+                                     | simd_bitmask(simd_cmpeq(t, simd_bcast('\r')))
+                                     | simd_bitmask(simd_cmpeq(t, simd_bcast('\n')))) << k;
+      bm.op |= static_cast<uint64_t>(simd_bitmask(simd_cmpeq(t, simd_bcast('[')))
+                                     | simd_bitmask(simd_cmpeq(t, simd_bcast(']')))
+                                     | simd_bitmask(simd_cmpeq(t, simd_bcast('{')))
+                                     | simd_bitmask(simd_cmpeq(t, simd_bcast('}')))
+                                     | simd_bitmask(simd_cmpeq(t, simd_bcast(':')))
+                                     | simd_bitmask(simd_cmpeq(t, simd_bcast(',')))) << k;
+    }
+#else
+    for(uint32_t k = 0;  k != 64;  ++k)
+      switch(s[k])
+        {
+        case '\\':
+          bm.bs |= uint64_t(1) << k;
+          break;
 
-                    if((temp[0] != '\\') || (temp[1] != 'u'))
-                      return do_err(ctx, "Missing UTF-16 trailing surrogate");
+        case '\"':
+          bm.qt |= uint64_t(1) << k;
+          break;
 
-                    int ls_value = ctx.c - 0xD800;
-                    ctx.c = 0;
-                    for(uint32_t k = 2;  k != 6;  ++k) {
-                      ctx.c <<= 4;
-                      int c = static_cast<uint8_t>(temp[k]);
-                      if(is_within(c, '0', '9'))
-                        ctx.c |= c - '0';
-                      else if(is_within(c, 'A', 'F'))
-                        ctx.c |= c - 'A' + 10;
-                      else if(is_within(c, 'a', 'f'))
-                        ctx.c |= c - 'a' + 10;
-                      else
-                        return do_err(ctx, "Invalid hexadecimal digit");
-                    }
+        case ' ':
+        case '\t':
+        case '\r':
+        case '\n':
+          bm.ws |= uint64_t(1) << k;
+          break;
 
-                    if(!is_within(ctx.c, 0xDC00, 0xDFFF))
-                      return do_err(ctx, "Missing UTF-16 trailing surrogate");
+        case '[':
+        case ']':
+        case '{':
+        case '}':
+        case ':':
+        case ',':
+          bm.op |= uint64_t(1) << k;
+          break;
+        }
+#endif
+  }
 
-                    ctx.c = 0x10000 + (ls_value << 10) + (ctx.c - 0xDC00);
-                  }
-                }
-                break;
+// These are carried from one block to the next.
+struct Block_Scanner
+  {
+    uint64_t escaped_carry = 0;  // first byte is escaped
+    uint64_t string_carry = 0;  // all ones if inside a string
+    uint64_t scalar_carry = 0;  // last byte was part of a scalar token
+  };
 
-              default:
-                return do_err(ctx, "Invalid escape sequence");
-              }
-          }
+// Skips the UTF-8 BOM, if any.
+const char*
+do_skip_bom(const char* bptr, const char* eptr)
+  {
+    if((eptr - bptr >= 3) && ::asteria::xmemeq(bptr, "\xEF\xBB\xBF", 3))
+      return bptr + 3;
+    else
+      return bptr;
+  }
 
-          // Move the unescaped character into the token.
-          if(ASTERIA_EXPECT(ctx.c <= 0x7F))
-            token.push_back(static_cast<char>(ctx.c));
-          else {
-            char mbs[MB_LEN_MAX];
-            ::std::mbstate_t mbst = { };
-            size_t mblen = ::std::c32rtomb(mbs, static_cast<char32_t>(ctx.c), &mbst);
-            if(static_cast<int>(mblen) < 0)
-              return do_err(ctx, "Character not representable in current locale");
+// Classifies characters in `[sptr,eptr)`, and calls `func(base, ops, others)`
+// for each block of 64 bytes, where `base` is the offset of the block from
+// `bptr`, `ops` is the mask of structural characters outside strings, and
+// `others` is the mask of unescaped double quotes and the first characters of
+// all other tokens. If the function returns `false`, scanning stops. Scanning
+// may be resumed with the same `scan` from where it stopped, or from the end
+// of a previous range, as long as that is a multiple of 64 bytes.
+template<typename xFunc>
+void
+do_scan_blocks(Block_Scanner& scan, const char* bptr, const char* sptr, const char* eptr,
+               xFunc&& func)
+  {
+    char temp[64];
+    for(;  sptr < eptr;  sptr += 64) {
+      // The last block is padded with spaces.
+      auto blk = sptr;
+      if(eptr - sptr < 64) {
+        ::std::memset(temp, ' ', 64);
+        ::std::memcpy(temp, sptr, static_cast<size_t>(eptr - sptr));
+        blk = temp;
+      }
 
-            ASTERIA_ASSERT(mblen != 0);
-            token.append(mbs, mblen);
-          }
-        }
+      Block_Masks bm;
+      do_classify_block(bm, blk);
+
+      // Find characters that are preceded by an odd number of backslashes.
+      // Backslashes are rare, so it's fine to walk them one by one.
+      uint64_t escaped = scan.escaped_carry;
+      uint64_t bits = bm.bs & ~scan.escaped_carry;
+      scan.escaped_carry = 0;
+      while(bits != 0) {
+        uint32_t k = static_cast<uint32_t>(::asteria::tzcnt64(bits));
+        if(k == 63)
+          scan.escaped_carry = 1;
+        else
+          escaped |= uint64_t(2) << k;
+        bits &= ~(uint64_t(3) << k);
+      }
 
-        // Drop the terminating quotation mark for simplicity; do not attempt to
-        // get the next character, as the stream may be blocking but we can't
-        // really know whether there are more data.
-        ASTERIA_ASSERT(token.size() != 0);
-        ctx.error = nullptr;
-        ctx.c = -1;
-        break;
+      // Unescaped quotes delimit strings. A string mask, which is the prefix
+      // XOR of all quotes, includes the opening quote but not the closing one.
+      uint64_t quotes = bm.qt & ~escaped;
+      uint64_t in_string = quotes;
+      for(uint32_t n = 1;  n != 64;  n *= 2)
+        in_string ^= in_string << n;
 
-      default:
-        return do_err(ctx, "Invalid character");
-      }
+      in_string ^= scan.string_carry;
+      scan.string_carry = 0 - (in_string >> 63);
+
+      // Any other character that is outside a string starts a scalar token if
+      // it is not preceded by another one.
+      uint64_t scalar = ~(bm.ws | bm.op | quotes | in_string);
+      uint64_t starts = scalar & ~((scalar << 1) | scan.scalar_carry);
+      scan.scalar_carry = scalar >> 63;
+
+      if(!func(static_cast<size_t>(sptr - bptr), bm.op & ~in_string, quotes | starts))
+        break;
+    }
   }
 
+template<typename xFunc>
 void
-do_parse_with(Value& root, Parser_Context& ctx, const Unified_Source& usrc, Options opts)
+do_scan_blocks(const char* bptr, const char* eptr, xFunc&& func)
   {
-    // Initialize parser state.
-    root.clear();
-    ::std::memset(&ctx, 0, sizeof(ctx));
-    ctx.c = -1;
+    Block_Scanner scan;
+    do_scan_blocks(scan, bptr, do_skip_bom(bptr, eptr), eptr, func);
+  }
 
-    // Break deep recursion with a handwritten stack.
-    struct xFrame
-      {
-        Value* target;
-        V_array* psa;
-        V_object* pso;
-      };
+// This is the structural index of a memory source. It is built in windows as
+// the second stage proceeds, and entries that have been consumed are discarded,
+// so its size is bounded by the window size, instead of the size of input.
+// For each open bracket or brace, the number of elements or members of its
+// array or object is counted, so the parser can allocate exact capacities.
+struct Structural_Index
+  {
+    static constexpr size_t window_size = 64 * 1024;
 
-    ::std::vector<xFrame> stack;
-    ::asteria::cow_string token;
-    ::asteria::ascii_numget numg;
-    ::std::multimap<size_t, ::asteria::phcow_string> key_pool;
-    Value* pstor = &root;
+    // If an array or object is not closed in the current window, up to this many
+    // bytes after it are indexed in advance to find its count.
+    static constexpr size_t lookahead_size = 256 * 1024;
 
-    do_token(token, ctx, usrc);
-    if(ctx.error)
-      return;
+    // This denotes an unknown count in `counts`, and a discarded entry in
+    // `opens`.
+    static constexpr uint32_t npos = UINT32_MAX;
 
-    if(token.empty())
-      return do_err(ctx, "Blank input");
+    struct xOpen
+      {
+        uint32_t pos;  // index into `offsets`
+        uint32_t commas;
+      };
 
-  do_pack_value_loop_:
-    if(!(opts & option_bypass_nesting_limit) && (stack.size() > 32))
-      return do_err(ctx, "Nesting limit exceeded");
+    ::std::vector<uint32_t> offsets;  // offsets of tokens from `bptr`
+    ::std::vector<uint32_t> counts;  // for open brackets and braces in `offsets`
+    ::std::vector<xOpen> opens;  // arrays and objects that have not been closed
+    Block_Scanner scan;
+    const char* bptr = nullptr;
+    const char* sptr = nullptr;  // start of the next window
+    const char* eptr = nullptr;
+  };
 
-    if(token[0] == '[') {
-      // array
-      do_token(token, ctx, usrc);
-      if(ctx.eof)
-        return do_err(ctx, "Array not terminated properly");
-      else if(ctx.error)
-        return;
+// Starts indexing `[bptr,eptr)`. No input is indexed until it is requested.
+void
+do_reset_index(Structural_Index& idx, const char* bptr, const char* eptr)
+  {
+    ASTERIA_ASSERT(static_cast<uint64_t>(eptr - bptr) <= UINT32_MAX);
+    idx.offsets.clear();
+    idx.counts.clear();
+    idx.opens.clear();
+    idx.scan = Block_Scanner();
+    idx.bptr = bptr;
+    idx.sptr = do_skip_bom(bptr, eptr);
+    idx.eptr = eptr;
+  }
 
-      if(token[0] != ']') {
-        // open
-        auto& frm = stack.emplace_back();
-        frm.target = pstor;
-        frm.psa = &(pstor->open_array());
+// Indexes the next window of input, and appends its entries. Counts of arrays
+// and objects that are closed in this window are stored. Returns `false` if
+// all input has been indexed.
+bool
+do_extend_index(Structural_Index& idx)
+  {
+    if(idx.sptr == idx.eptr)
+      return false;
+
+    auto weptr = idx.sptr + ::std::min<size_t>(static_cast<size_t>(idx.eptr - idx.sptr),
+                                               Structural_Index::window_size);
+    size_t k = idx.offsets.size();
+    do_scan_blocks(idx.scan, idx.bptr, idx.sptr, weptr,
+      [&](size_t base, uint64_t ops, uint64_t others)
+        {
+          uint64_t mask = ops | others;
+          while(mask != 0) {
+            idx.offsets.push_back(static_cast<uint32_t>(base + ::asteria::tzcnt64(mask)));
+            mask &= mask - 1;
+          }
+          return true;
+        });
 
-        // first
-        pstor = &(frm.psa->emplace_back());
-        goto do_pack_value_loop_;
-      }
+    idx.sptr = weptr;
+    idx.counts.resize(idx.offsets.size(), Structural_Index::npos);
 
-      // empty
-      pstor->open_array();
-    }
-    else if(token[0] == '{') {
-      // object
-      do_token(token, ctx, usrc);
-      if(ctx.eof)
-        return do_err(ctx, "Object not terminated properly");
-      else if(ctx.error)
-        return;
+    // Count elements and members. If the input is malformed, counts may be
+    // wrong, but the parser will fail anyway.
+    for(;  k != idx.offsets.size();  ++k)
+      switch(idx.bptr[idx.offsets[k]])
+        {
+        case '[':
+        case '{':
+          idx.opens.push_back({ static_cast<uint32_t>(k), 0 });
+          break;
 
-      if(token[0] != '}') {
-        // open
-        auto& frm = stack.emplace_back();
-        frm.target = pstor;
-        frm.pso = &(pstor->open_object());
+        case ']':
+        case '}':
+          if(!idx.opens.empty()) {
+            auto open = idx.opens.back();
+            idx.opens.pop_back();
 
-        // We are inside an object, so this token must be a key string, followed
-        // by a colon, followed by its value.
-        if(token[0] != '\"')
-          return do_err(ctx, "Missing key string");
+            // An empty array or object is followed by its close bracket or brace.
+            if(open.pos != Structural_Index::npos)
+              idx.counts[open.pos] = (open.pos + 1 == k) ? 0 : open.commas + 1;
+          }
+          break;
 
-        auto emr = frm.pso->try_emplace(do_intern_string(key_pool, token.data() + 1, token.size() - 1));
-        ASTERIA_ASSERT(emr.second);
+        case ',':
+          if(!idx.opens.empty())
+            idx.opens.back().commas ++;
+          break;
+        }
 
-        do_token(token, ctx, usrc);
-        if(token[0] != ':')
-          return do_err(ctx, "Missing colon");
+    return true;
+  }
 
-        do_token(token, ctx, usrc);
-        if(ctx.eof)
-          return do_err(ctx, "Missing value");
-        else if(ctx.error)
-          return;
+// Makes sure that the next token has been indexed, unless the end of input has
+// been reached. This is called when all entries have been consumed, which are
+// discarded. Arrays and objects that are still open are kept for matching, but
+// their counts are no longer needed.
+bool
+do_fill_index(Memory_Source& usrc)
+  {
+    ASTERIA_ASSERT(usrc.index);
+    ASTERIA_ASSERT(usrc.iptr == usrc.ieptr);
+    auto& idx = *(usrc.index);
+
+    idx.offsets.clear();
+    idx.counts.clear();
+    for(auto& open : idx.opens)
+      open.pos = Structural_Index::npos;
+
+    while(idx.offsets.empty() && do_extend_index(idx));
+    usrc.iptr = idx.offsets.data();
+    usrc.ieptr = idx.offsets.data() + idx.offsets.size();
+    return usrc.iptr != usrc.ieptr;
+  }
 
-        // first
-        pstor = &(emr.first->second);
-        goto do_pack_value_loop_;
-      }
+// Checks whether `[bptr,eptr)` is exactly a number or an identifier, as would
+// be accepted by `do_token()`.
+bool
+is_scalar_token(const char* bptr, const char* eptr)
+  {
+    auto tptr = bptr;
+    if(tptr == eptr)
+      return false;
 
-      // empty
-      pstor->open_object();
-    }
-    else if(is_any(token[0], '+', '-') || is_within(token[0], '0', '9')) {
-      // number
-      size_t n = numg.parse_DD(token.data(), token.size());
-      ASTERIA_ASSERT(n == token.size());
-      numg.cast_D(pstor->open_number(), -DBL_MAX, DBL_MAX);
-      if(numg.overflowed())
-        return do_err(ctx, "Number out of range");
+    if(is_any(*tptr, '_', '$') || is_within(*tptr, 'A', 'Z') || is_within(*tptr, 'a', 'z')) {
+      // identifier
+      do
+        ++ tptr;
+      while((tptr != eptr) && (is_any(*tptr, '_', '$') || is_within(*tptr, 'A', 'Z')
+                               || is_within(*tptr, 'a', 'z') || is_within(*tptr, '0', '9')));
+      return tptr == eptr;
     }
-    else if(token[0] == '\"') {
-      // string
-      if((opts & option_json_mode) || (token[1] != '$')) {
-        // plain
-        pstor->open_string().assign(token.data() + 1, token.size() - 1);
-      }
-      else if((token[2] == 'l') && (token[3] == ':')) {
-        // 64-bit integer
-        if(numg.parse_I(token.data() + 4, token.size() - 4) != token.size() - 4)
-          return do_err(ctx, "Invalid 64-bit integer");
 
-        numg.cast_I(pstor->open_integer(), INT64_MIN, INT64_MAX);
-        if(numg.overflowed())
-          return do_err(ctx, "64-bit integer value out of range");
-      }
-      else if((token[2] == 'd') && (token[3] == ':')) {
-        // double-precision number
-        if(numg.parse_D(token.data() + 4, token.size() - 4) != token.size() - 4)
-          return do_err(ctx, "Invalid double-precision number");
+    // number
+    if(is_any(*tptr, '+', '-'))
+      ++ tptr;
 
-        // Values that are out of range are converted to infinities and are
-        // always accepted.
-        numg.cast_D(pstor->open_number(), -HUGE_VAL, HUGE_VAL);
-      }
-      else if((token[2] == 's') && (token[3] == ':')) {
-        // annotated string
-        pstor->open_string().assign(token.data() + 4, token.size() - 4);
-      }
-      else if((token[2] == 't') && (token[3] == ':')) {
-        // timestamp in milliseconds
-        if(numg.parse_I(token.data() + 4, token.size() - 4) != token.size() - 4)
-          return do_err(ctx, "Invalid timestamp");
+    if((tptr == eptr) || !is_within(*tptr, '0', '9'))
+      return false;
 
-        // The allowed timestamp values are from '1900-01-01T00:00:00.000Z' to
-        // '9999-12-31T23:59:59.999Z'.
-        int64_t count;
-        numg.cast_I(count, -2208988800000, 253402300799999);
-        pstor->open_time() = V_time(::std::chrono::milliseconds(count));
-        if(numg.overflowed())
-          return do_err(ctx, "Timestamp value out of range");
-      }
-      else if((token[2] == 'h') && (token[3] == ':')) {
-        // hex-encoded data
-        size_t units = (token.size() - 4) / 2;
-        if(units * 2 != token.size() - 4)
-          return do_err(ctx, "Invalid hex string");
-
-        auto& bin = pstor->open_binary();
-        bin.reserve(units);
-
-        auto bptr = token.data() + 4;
-        const auto eptr = token.data() + token.size();
-        while(bptr != eptr) {
-          uint32_t value = 0;
-          for(int k = 0;  k != 2;  ++k) {
-            value <<= 4;
-            int c = static_cast<uint8_t>(bptr[k]);
-            if(is_within(c, '0', '9'))
-              value |= static_cast<uint32_t>(c - '0');
-            else if(is_within(c, 'A', 'F'))
-              value |= static_cast<uint32_t>(c - 'A' + 10);
-            else if(is_within(c, 'a', 'f'))
-              value |= static_cast<uint32_t>(c - 'a' + 10);
-            else
-              return do_err(ctx, "Invalid hexadecimal digit");
-          }
+    do
+      ++ tptr;
+    while((tptr != eptr) && is_within(*tptr, '0', '9'));
 
-          bin.push_back(static_cast<uint8_t>(value));
-          bptr += 2;
-        }
-      }
-      else if((token[2] == 'b') && (token[3] == ':')) {
-        // base64-encoded data
-        size_t units = (token.size() - 4) / 4;
-        if(units * 4 != token.size() - 4)
-          return do_err(ctx, "Invalid base64 string");
-
-        auto& bin = pstor->open_binary();
-        bin.reserve(units);
-
-        auto bptr = token.data() + 4;
-        const auto eptr = token.data() + token.size();
-        while(bptr != eptr) {
-          uint32_t value = 0;
-          uint32_t out_bytes = 3;
-          for(int k = 0;  k != 4;  ++k) {
-            value <<= 6;
-            int c = static_cast<uint8_t>(bptr[k]);
-            if(is_within(c, 'A', 'Z'))
-              value |= static_cast<uint32_t>(c - 'A');
-            else if(is_within(c, 'a', 'z'))
-              value |= static_cast<uint32_t>(c - 'a' + 26);
-            else if(is_within(c, '0', '9'))
-              value |= static_cast<uint32_t>(c - '0' + 52);
-            else if(c == '+')
-              value |= 62;
-            else if(c == '/')
-              value |= 63;
-            else if(c == '=') {
-              if(k >= 2)
-                out_bytes --;
-              else
-                return do_err(ctx, "Invalid base64 string");
-            }
-            else
-              return do_err(ctx, "Invalid base64 digit");
-          }
+    if((tptr != eptr) && (*tptr == '.')) {
+      ++ tptr;
+      if((tptr == eptr) || !is_within(*tptr, '0', '9'))
+        return false;
 
-          uint8_t piece[4];
-          ::asteria::store_be<uint32_t>(piece, value << 8);
-          bin.append(piece, out_bytes);
-          bptr += 4;
-        }
-      }
-      else
-        return do_err(ctx, "Unknown type annotator");
+      do
+        ++ tptr;
+      while((tptr != eptr) && is_within(*tptr, '0', '9'));
     }
-    else if(token == "null")
-      pstor->clear();
-    else if(token == "true")
-      pstor->open_boolean() = true;
-    else if(token == "false")
-      pstor->open_boolean() = false;
-    else
-      return do_err(ctx, "Invalid token");
-
-    while(!stack.empty()) {
-      const auto& frm = stack.back();
-      if(frm.psa) {
-        // array
-        do_token(token, ctx, usrc);
-        if(ctx.eof)
-          return do_err(ctx, "Array not terminated properly");
-        else if(ctx.error)
-          return;
-
-        if(token[0] != ']') {
-          if(token[0] != ',')
-            return do_err(ctx, "Missing comma or closed bracket");
 
-          do_token(token, ctx, usrc);
-          if(ctx.eof)
-            return do_err(ctx, "Missing value");
-          else if(ctx.error)
-            return;
-
-          if((token[0] != ']') || !(opts & option_allow_trailing_commas)) {
-            // next
-            pstor = &(frm.psa->emplace_back());
-            goto do_pack_value_loop_;
-          }
-        }
-      }
-      else {
-        // object
-        do_token(token, ctx, usrc);
-        if(ctx.eof)
-          return do_err(ctx, "Object not terminated properly");
-        else if(ctx.error)
-          return;
+    if((tptr != eptr) && is_any(*tptr, 'e', 'E')) {
+      ++ tptr;
+      if((tptr != eptr) && is_any(*tptr, '+', '-'))
+        ++ tptr;
 
-        if(token[0] != '}') {
-          if(token[0] != ',')
-            return do_err(ctx, "Missing comma or closed brace");
+      if((tptr == eptr) || !is_within(*tptr, '0', '9'))
+        return false;
 
-          do_token(token, ctx, usrc);
-          if(ctx.eof)
-            return do_err(ctx, "Missing key string");
-          else if(ctx.error)
-            return;
-
-          if((token[0] != '}') || !(opts & option_allow_trailing_commas)) {
-            // We are inside an object, so this token must be a key string,
-            // followed by a colon, followed by its value.
-            if(token[0] != '\"')
-              return do_err(ctx, "Missing key string");
-
-            auto emr = frm.pso->try_emplace(do_intern_string(key_pool, token.data() + 1, token.size() - 1));
-            if(!emr.second)
-              return do_err(ctx, "Duplicate key string");
-
-            do_token(token, ctx, usrc);
-            if(token[0] != ':')
-              return do_err(ctx, "Missing colon");
-
-            do_token(token, ctx, usrc);
-            if(ctx.eof)
-              return do_err(ctx, "Missing value");
-            else if(ctx.error)
-              return;
+      do
+        ++ tptr;
+      while((tptr != eptr) && is_within(*tptr, '0', '9'));
+    }
 
-            // next
-            pstor = &(emr.first->second);
-            goto do_pack_value_loop_;
-          }
-        }
-      }
+    return tptr == eptr;
+  }
 
-      // close
-      pstor = frm.target;
-      stack.pop_back();
+template<typename xSource>
+void
+do_load_next(Parser_Context& ctx, xSource& usrc)
+  {
+    ctx.c = usrc.getc();
+    if(ctx.c < 0) {
+      ctx.eof = true;
+      return do_err(ctx, nullptr);
+    }
+
+    if(is_within(ctx.c, 0x80, 0xBF) || (ctx.c > 0xF7))
+      return do_err(ctx, "Invalid UTF-8 byte");
+    else if(ASTERIA_UNEXPECT(ctx.c > 0x7F)) {
+      // Parse a multibyte Unicode character.
+      uint32_t u8len = ::asteria::lzcnt32((static_cast<uint32_t>(ctx.c) << 24) ^ UINT32_MAX);
+      ctx.c &= (1 << (7 - u8len)) - 1;
+
+      char tbytes[4];
+      if(usrc.getn(tbytes, u8len - 1) != u8len - 1) {
+        ctx.eof = true;
+        return do_err(ctx, "Incomplete UTF-8 sequence");
+      }
+
+      for(uint32_t k = 0;  k != u8len - 1;  ++k)
+        if(!is_within(static_cast<uint8_t>(tbytes[k]), 0x80, 0xBF))
+          return do_err(ctx, "Invalid UTF-8 sequence");
+        else {
+          ctx.c <<= 6;
+          ctx.c |= tbytes[k] & 0x3F;
+        }
+
+      if((ctx.c < 0x80)  // overlong
+          || (ctx.c < (1 << (u8len * 5 - 4)))  // overlong
+          || is_within(ctx.c, 0xD800, 0xDFFF)  // surrogates
+          || (ctx.c > 0x10FFFF))
+        return do_err(ctx, "Invalid Unicode character");
     }
   }
 
+template<typename xSource>
 ASTERIA_FLATTEN
 void
-do_escape_string_utf16(const Unified_Sink& usink, const ::asteria::cow_string& str)
+do_token(Parser_Token& token, Parser_Context& ctx, xSource& usrc)
   {
-    auto bptr = str.data();
-    const auto eptr = str.data() + str.size();
-    for(;;) {
-      // Get a sequence of characters that require no escaping.
-      auto tptr = bptr;
-      while(eptr != tptr) {
-        if(is_any(*tptr, '\\', '\"', '/') || !is_within(*tptr, 0x20, 0x7E))
-          goto break_found_;
-        ++ tptr;
+    // Clear the current token and skip whitespace.
+    ctx.error = nullptr;
+    token.clear();
 
-#ifdef TAXON_HAS_SIMD
-        while(eptr - tptr >= static_cast<ptrdiff_t>(sizeof(simd_word_type))) {
-          simd_word_type t = simd_load(tptr);
-          simd_mask_type mask = simd_movmask(simd_cmpeq(t, simd_bcast('\\')))
-                                | simd_movmask(simd_cmpeq(t, simd_bcast('\"')))
-                                | simd_movmask(simd_cmpeq(t, simd_bcast('/')))
-                                | simd_movmask(simd_cmpgt(simd_bcast(0x20), t))
-                                | simd_movmask(simd_cmpgt(t, simd_bcast(0x7E)));
-          tptr += simd_tzcnt(mask);
-          if(mask != 0)
-            goto break_found_;
+    if(ctx.c < 0) {
+      if constexpr(is_memory_source<xSource>)
+        if(usrc.index) {
+          // Jump to the next token, unless we are in the middle of a sequence
+          // of non-whitespace characters after an invalid one. Whitespace and
+          // the UTF-8 BOM have been skipped by the indexer.
+          auto tptr = usrc.eptr;
+          while((usrc.iptr != usrc.ieptr) || do_fill_index(usrc)) {
+            tptr = usrc.bptr + *(usrc.iptr);
+            if(ASTERIA_EXPECT(tptr >= usrc.sptr))
+              break;
+
+            // Drop an indexed character that has been consumed already. This
+            // happens if it has been swallowed by an invalid UTF-8 sequence after
+            // an identifier, such as the comma in `null\xEF,\xBF`.
+            usrc.iptr ++;
+            tptr = usrc.eptr;
+          }
+
+          if((usrc.sptr == usrc.bptr) || (usrc.sptr == tptr)
+             || ((usrc.sptr != usrc.eptr) && is_any(*(usrc.sptr), ' ', '\t', '\r', '\n'))) {
+            usrc.sptr = tptr;
+            usrc.iptr += tptr != usrc.eptr;
+          }
         }
-#endif
+
+      ctx.saved_offset = usrc.tell();
+      do_load_next(ctx, usrc);
+      if(ctx.c < 0)
+        return;
+
+      // Skip the UTF-8 BOM, if any.
+      if((ctx.saved_offset == 0) && (ctx.c == 0xFEFF)) {
+        ctx.saved_offset = usrc.tell();
+        do_load_next(ctx, usrc);
+        if(ctx.c < 0)
+          return;
       }
+    }
+    else {
+      // The token starts with the lookahead character, which has been consumed
+      // from the source.
+      ctx.saved_offset = usrc.tell() - 1 - (ctx.c > 0x7F) - (ctx.c > 0x7FF) - (ctx.c > 0xFFFF);
+    }
+
+    while(is_any(ctx.c, ' ', '\t', '\r', '\n')) {
+      if constexpr(is_memory_source<xSource>) {
+        auto tptr = usrc.sptr;
+        while(usrc.eptr != tptr) {
+          if(!is_any(*tptr, ' ', '\t', '\r', '\n'))
+            goto break_found_;
+          ++ tptr;
+
+#ifdef TAXON_HAS_SIMD
+          while(usrc.eptr - tptr >= static_cast<ptrdiff_t>(sizeof(simd_word_type))) {
+            simd_word_type t = simd_load(tptr);
+            simd_mask_type mask = simd_movmask(simd_bcast(0xFF))
+                                  ^ (simd_movmask(simd_cmpeq(t, simd_bcast(' ')))
+                                     | simd_movmask(simd_cmpeq(t, simd_bcast('\t')))
+                                     | simd_movmask(simd_cmpeq(t, simd_bcast('\r')))
+                                     | simd_movmask(simd_cmpeq(t, simd_bcast('\n'))));
+            tptr += simd_tzcnt(mask);
+            if(mask != 0)
+              goto break_found_;
+          }
+#endif
+        }
 
   break_found_:
-      if(tptr != bptr)
-        usink.putn(bptr, static_cast<size_t>(tptr - bptr));
-      bptr = tptr;
+        usrc.sptr = tptr;
+      }
+      else if constexpr(is_file_source<xSource>) {
+        (void)! ::fscanf(usrc.fp, "%*[ \t\r\n]");
+      }
 
-      if(bptr == eptr)
+      ctx.saved_offset = usrc.tell();
+      do_load_next(ctx, usrc);
+      if(ctx.c < 0)
+        return;
+    }
+
+    if constexpr(is_memory_source<xSource>)
+      if(usrc.index && (is_any(ctx.c, '_', '$', '+', '-') || is_within(ctx.c, 'A', 'Z')
+                       || is_within(ctx.c, 'a', 'z') || is_within(ctx.c, '0', '9'))) {
+        // In indexed mode, a number or identifier extends to the next whitespace
+        // or the next indexed token, whichever comes first. If it is well-formed,
+        // take it as a whole; otherwise, rescan it below for diagnostics.
+        auto tbptr = usrc.sptr - 1;
+        auto teptr = usrc.eptr;
+        if((usrc.iptr != usrc.ieptr) || do_fill_index(usrc))
+          teptr = usrc.bptr + *(usrc.iptr);
+
+        auto tptr = tbptr;
+        while((tptr != teptr) && !is_any(*tptr, ' ', '\t', '\r', '\n'))
+          ++ tptr;
+
+        if(is_scalar_token(tbptr, tptr)) {
+          token.set_view(tbptr, static_cast<size_t>(tptr - tbptr));
+          usrc.sptr = tptr;
+          ctx.c = -1;
+          return;
+        }
+      }
+
+    switch(ctx.c)
+      {
+      case '[':
+      case ']':
+      case '{':
+      case '}':
+      case ':':
+      case ',':
+        // Take each of these characters as a single token; do not attempt to get
+        // the next character, as some of these tokens may terminate the input,
+        // and the stream may be blocking but we can't really know whether there
+        // are more data.
+        token.push_back(static_cast<char>(ctx.c));
+        ctx.c = -1;
         break;
 
-      int next = static_cast<uint8_t>(*(bptr ++));
-      switch(next)
-        {
-        case '\\':
-        case '\"':
-        case '/':
-          {
-            char temp[2] = { '\\', static_cast<char>(next) };
-            usink.putn(temp, 2);
+      case '_':
+      case '$':
+      case 'A' ... 'Z':
+      case 'a' ... 'z':
+        // Take an identifier. As in JavaScript, we accept dollar signs in
+        // identifiers as an extension.
+        do {
+          token.push_back(static_cast<char>(ctx.c));
+          do_load_next(ctx, usrc);
+        }
+        while(is_any(ctx.c, '_', '$') || is_within(ctx.c, 'A', 'Z')
+              || is_within(ctx.c, 'a', 'z') || is_within(ctx.c, '0', '9'));
+
+        // If the end of input has been reached, `ctx.error` may be set. We will
+        // not return an error, so clear it.
+        ASTERIA_ASSERT(token.size() != 0);
+        ctx.error = nullptr;
+        ctx.eof = false;
+        break;
+
+      case '+':
+      case '-':
+        // Take a floating-point number. Strictly, JSON doesn't allow plus signs
+        // or leading zeroes, but we accept them as extensions.
+        token.push_back(static_cast<char>(ctx.c));
+        do_load_next(ctx, usrc);
+
+        if(!is_within(ctx.c, '0', '9'))
+          return do_err(ctx, "Invalid number");
+
+        do {  // fallthrough
+      case '0' ... '9':
+          token.push_back(static_cast<char>(ctx.c));
+          do_load_next(ctx, usrc);
+        } while(is_within(ctx.c, '0', '9'));
+
+        if(ctx.c == '.') {
+          token.push_back(static_cast<char>(ctx.c));
+          do_load_next(ctx, usrc);
+
+          if(!is_within(ctx.c, '0', '9'))
+            return do_err(ctx, "Invalid number");
+
+          do {
+            token.push_back(static_cast<char>(ctx.c));
+            do_load_next(ctx, usrc);
+          } while(is_within(ctx.c, '0', '9'));
+        }
+
+        if(is_any(ctx.c, 'e', 'E')) {
+          token.push_back(static_cast<char>(ctx.c));
+          do_load_next(ctx, usrc);
+
+          if(is_any(ctx.c, '+', '-')) {
+            token.push_back(static_cast<char>(ctx.c));
+            do_load_next(ctx, usrc);
           }
-          break;
 
-        case '\b':
-          usink.putn("\\b", 2);
-          break;
+          if(!is_within(ctx.c, '0', '9'))
+            return do_err(ctx, "Invalid number");
 
-        case '\f':
-          usink.putn("\\f", 2);
-          break;
+          do {
+            token.push_back(static_cast<char>(ctx.c));
+            do_load_next(ctx, usrc);
+          } while(is_within(ctx.c, '0', '9'));
+        }
 
-        case '\n':
-          usink.putn("\\n", 2);
-          break;
+        // If the end of input has been reached, `ctx.error` may be set. We will
+        // not return an error, so clear it.
+        ASTERIA_ASSERT(token.size() != 0);
+        ctx.error = nullptr;
+        ctx.eof = false;
+        break;
 
-        case '\r':
-          usink.putn("\\r", 2);
-          break;
+      case '\"':
+        // Take a double-quoted string. When stored in `token`, it shall start
+        // with a double-quote character, followed by the decoded string. No
+        // terminating double-quote character is appended. For memory sources,
+        // the opening quotation mark is copied with the first run of plain
+        // characters below.
+        if constexpr(!is_memory_source<xSource>)
+          token.push_back('\"');
 
-        case '\t':
-          usink.putn("\\t", 2);
-          break;
+        for(;;) {
+          if constexpr(is_memory_source<xSource>) {
+            auto tptr = usrc.sptr;
+            while(usrc.eptr != tptr) {
+              if(is_any(*tptr, '\\', '\"') || !is_within(*tptr, 0x20, 0x7E))
+                goto escape_found_;
+              ++ tptr;
 
-        default:
-          if(is_within(next, 0x20, 0x7E))
-            usink.putc(static_cast<char>(next));
-          else {
-            // Read a multibyte character.
-            char16_t c16;
-            ::std::mbstate_t mbst = { };
-            size_t mblen = ::std::mbrtoc16(&c16, tptr, static_cast<size_t>(eptr - tptr), &mbst);
-            if(static_cast<int>(mblen) < 0) {
-              // The input string is invalid. Consume one byte anyway, but print
-              // a replacement character.
-              usink.putn("\\uFFFD", 6);
+#ifdef TAXON_HAS_SIMD
+              while(usrc.eptr - tptr >= static_cast<ptrdiff_t>(sizeof(simd_word_type))) {
+                simd_word_type t = simd_load(tptr);
+                simd_mask_type mask = simd_movmask(simd_cmpeq(t, simd_bcast('\\')))
+                                      | simd_movmask(simd_cmpeq(t, simd_bcast('\"')))
+                                      | simd_movmask(simd_cmpgt(simd_bcast(0x20), t))
+                                      | simd_movmask(simd_cmpgt(t, simd_bcast(0x7E)));
+                tptr += simd_tzcnt(mask);
+                if(mask != 0)
+                  goto escape_found_;
+              }
+#endif
             }
-            else if(mblen == 0) {
-              // A null byte has been consumed and stored into `c16`.
-              usink.putn("\\u0000", 6);
-            }
-            else {
-              // `mblen` bytes have been consumed, converted and stored into `c16`.
-              char temp[16] = "\\u1234\\u5678zzz";
-              uint32_t tlen = 6;
-              for(uint32_t k = 2;  k != 6;  ++k) {
-                int c = c16 >> 12;
-                c16 = static_cast<uint16_t>(c16 << 4);
-                if(c < 10)
-                  temp[k] = static_cast<char>(c + '0');
-                else
-                  temp[k] = static_cast<char>(c - 10 + 'A');
+
+  escape_found_:
+            if(token.str.empty()) {
+              // This is the first run, so include the opening quotation mark. If
+              // the string contains nothing to decode, take it as a view into
+              // the source.
+              usrc.sptr --;
+              if((tptr != usrc.eptr) && (*tptr == '\"')) {
+                token.set_view(usrc.sptr, static_cast<size_t>(tptr - usrc.sptr));
+                usrc.sptr = tptr + 1;
+                break;
               }
+            }
 
-              if(static_cast<int>(::std::mbrtoc16(&c16, nullptr, 0, &mbst)) == -3) {
-                // No input has been consumed, but a trailing surrogate has been
-                // stored into `c16`.
-                tlen = 12;
-                for(uint32_t k = 8;  k != 12;  ++k) {
-                  int c = c16 >> 12;
-                  c16 = static_cast<uint16_t>(c16 << 4);
-                  if(c < 10)
-                    temp[k] = static_cast<char>(c + '0');
-                  else
-                    temp[k] = static_cast<char>(c - 10 + 'A');
+            if(tptr != usrc.sptr)
+              token.append(usrc.sptr, static_cast<size_t>(tptr - usrc.sptr));
+            usrc.sptr = tptr;
+          }
+          else if constexpr(is_file_source<xSource>) {
+            char temp[256];
+            size_t len;
+            while(::fscanf(usrc.fp, "%255[]-~ !#-[]%zn", temp, &len) == 1) {
+              token.append(temp, len);
+              if(len < 256)
+                break;
+            }
+          }
+
+          do_load_next(ctx, usrc);
+          if(ctx.eof)
+            return do_err(ctx, "String not terminated properly");
+          else if((ctx.c <= 0x1F) || (ctx.c == 0x7F))
+            return do_err(ctx, "Control character not allowed in string");
+          else if(ctx.c == '\"')
+            break;
+
+          if(ASTERIA_UNEXPECT(ctx.c == '\\')) {
+            // Read an escape sequence.
+            int next = usrc.getc();
+            if(next < 0) {
+              ctx.eof = true;
+              return do_err(ctx, "Incomplete escape sequence");
+            }
+
+            switch(next)
+              {
+              case '\\':
+              case '\"':
+              case '/':
+                ctx.c = next;
+                break;
+
+              case 'b':
+                ctx.c = '\b';
+                break;
+
+              case 'f':
+                ctx.c = '\f';
+                break;
+
+              case 'n':
+                ctx.c = '\n';
+                break;
+
+              case 'r':
+                ctx.c = '\r';
+                break;
+
+              case 't':
+                ctx.c = '\t';
+                break;
+
+              case 'u':
+                {
+                  // Read the first UTF-16 code unit.
+                  char temp[16];
+                  if(usrc.getn(temp, 4) != 4)
+                    return do_err(ctx, "Invalid escape sequence");
+
+                  ctx.c = 0;
+                  for(uint32_t k = 0;  k != 4;  ++k) {
+                    ctx.c <<= 4;
+                    int c = static_cast<uint8_t>(temp[k]);
+                    if(is_within(c, '0', '9'))
+                      ctx.c |= c - '0';
+                    else if(is_within(c, 'A', 'F'))
+                      ctx.c |= c - 'A' + 10;
+                    else if(is_within(c, 'a', 'f'))
+                      ctx.c |= c - 'a' + 10;
+                    else
+                      return do_err(ctx, "Invalid hexadecimal digit");
+                  }
+
+                  if(is_within(ctx.c, 0xDC00, 0xDFFF))
+                    return do_err(ctx, "Dangling UTF-16 trailing surrogate");
+                  else if(is_within(ctx.c, 0xD800, 0xDBFF)) {
+                    // The character was a UTF-16 leading surrogate. Now look for
+                    // a trailing one, which must be another `\uXXXX` sequence.
+                    if(usrc.getn(temp, 6) != 6)
+                      return do_err(ctx, "Missing UTF-16 trailing surrogate");
+
+                    if((temp[0] != '\\') || (temp[1] != 'u'))
+                      return do_err(ctx, "Missing UTF-16 trailing surrogate");
+
+                    int ls_value = ctx.c - 0xD800;
+                    ctx.c = 0;
+                    for(uint32_t k = 2;  k != 6;  ++k) {
+                      ctx.c <<= 4;
+                      int c = static_cast<uint8_t>(temp[k]);
+                      if(is_within(c, '0', '9'))
+                        ctx.c |= c - '0';
+                      else if(is_within(c, 'A', 'F'))
+                        ctx.c |= c - 'A' + 10;
+                      else if(is_within(c, 'a', 'f'))
+                        ctx.c |= c - 'a' + 10;
+                      else
+                        return do_err(ctx, "Invalid hexadecimal digit");
+                    }
+
+                    if(!is_within(ctx.c, 0xDC00, 0xDFFF))
+                      return do_err(ctx, "Missing UTF-16 trailing surrogate");
+
+                    ctx.c = 0x10000 + (ls_value << 10) + (ctx.c - 0xDC00);
+                  }
                 }
+                break;
+
+              default:
+                return do_err(ctx, "Invalid escape sequence");
               }
+          }
+
+          // Move the unescaped character into the token.
+          if(ASTERIA_EXPECT(ctx.c <= 0x7F))
+            token.push_back(static_cast<char>(ctx.c));
+          else {
+            char mbs[MB_LEN_MAX];
+            ::std::mbstate_t mbst = { };
+            size_t mblen = ::std::c32rtomb(mbs, static_cast<char32_t>(ctx.c), &mbst);
+            if(static_cast<int>(mblen) < 0)
+              return do_err(ctx, "Character not representable in current locale");
+
+            ASTERIA_ASSERT(mblen != 0);
+            token.append(mbs, mblen);
+          }
+        }
+
+        // Drop the terminating quotation mark for simplicity; do not attempt to
+        // get the next character, as the stream may be blocking but we can't
+        // really know whether there are more data.
+        ASTERIA_ASSERT(token.size() != 0);
+        if constexpr(is_memory_source<xSource>)
+          if(usrc.index) {
+            // The terminating quotation mark is also indexed.
+            if(usrc.iptr == usrc.ieptr)
+              do_fill_index(usrc);
+
+            ASTERIA_ASSERT(usrc.bptr + *(usrc.iptr) == usrc.sptr - 1);
+            usrc.iptr ++;
+          }
+
+        ctx.error = nullptr;
+        ctx.c = -1;
+        break;
+
+      default:
+        return do_err(ctx, "Invalid character");
+      }
+
+    // In indexed mode, if the lookahead character is whitespace or starts the
+    // next indexed token, put it back, so the next call will jump from it.
+    if constexpr(is_memory_source<xSource>)
+      if(usrc.index && is_any(ctx.c, ' ', '\t', '\r', '\n', '[', ']', '{', '}', ':', ',', '\"')) {
+        usrc.sptr --;
+        ctx.c = -1;
+      }
+  }
+
+// Decodes hex-encoded data into `bin`.
+void
+do_decode_hex(V_binary& bin, Parser_Context& ctx, const char* str, size_t len)
+  {
+    size_t units = len / 2;
+    if(units * 2 != len)
+      return do_err(ctx, "Invalid hex string");
+
+    bin.assign(units, 0);
+    auto optr = bin.mut_data();
+
+    auto bptr = str;
+    const auto eptr = str + len;
+#ifdef TAXON_HAS_SIMD
+    // Decode a word of digits at a time. If an invalid digit is found, fall
+    // back to the loop below, which shall report it.
+    while(eptr - bptr >= static_cast<ptrdiff_t>(sizeof(simd_word_type))) {
+      if(!simd_decode_hex(optr, bptr))
+        break;
+
+      optr += sizeof(simd_word_type) / 2;
+      bptr += sizeof(simd_word_type);
+    }
+#endif
+    while(bptr != eptr) {
+      uint32_t value = 0;
+      for(int k = 0;  k != 2;  ++k) {
+        value <<= 4;
+        int c = static_cast<uint8_t>(bptr[k]);
+        if(is_within(c, '0', '9'))
+          value |= static_cast<uint32_t>(c - '0');
+        else if(is_within(c, 'A', 'F'))
+          value |= static_cast<uint32_t>(c - 'A' + 10);
+        else if(is_within(c, 'a', 'f'))
+          value |= static_cast<uint32_t>(c - 'a' + 10);
+        else
+          return do_err(ctx, "Invalid hexadecimal digit");
+      }
+
+      *optr = static_cast<uint8_t>(value);
+      optr ++;
+      bptr += 2;
+    }
+  }
+
+// Decodes base64-encoded data into `bin`.
+void
+do_decode_base64(V_binary& bin, Parser_Context& ctx, const char* str, size_t len)
+  {
+    size_t units = len / 4;
+    if(units * 4 != len)
+      return do_err(ctx, "Invalid base64 string");
+
+    bin.assign(units * 3, 0);
+    auto optr = bin.mut_data();
+
+    auto bptr = str;
+    const auto eptr = str + len;
+#ifdef TAXON_HAS_SIMD
+    // Decode a word of digits at a time. If an invalid digit or a padding
+    // character is found, fall back to the loop below, which shall handle
+    // it.
+    while(eptr - bptr >= static_cast<ptrdiff_t>(sizeof(simd_word_type))) {
+      if(!simd_decode_base64(optr, bptr))
+        break;
+
+      optr += sizeof(simd_word_type) / 4 * 3;
+      bptr += sizeof(simd_word_type);
+    }
+#endif
+    while(bptr != eptr) {
+      uint32_t value = 0;
+      uint32_t out_bytes = 3;
+      for(int k = 0;  k != 4;  ++k) {
+        value <<= 6;
+        int c = static_cast<uint8_t>(bptr[k]);
+        if(is_within(c, 'A', 'Z'))
+          value |= static_cast<uint32_t>(c - 'A');
+        else if(is_within(c, 'a', 'z'))
+          value |= static_cast<uint32_t>(c - 'a' + 26);
+        else if(is_within(c, '0', '9'))
+          value |= static_cast<uint32_t>(c - '0' + 52);
+        else if(c == '+')
+          value |= 62;
+        else if(c == '/')
+          value |= 63;
+        else if(c == '=') {
+          if(k >= 2)
+            out_bytes --;
+          else
+            return do_err(ctx, "Invalid base64 string");
+        }
+        else
+          return do_err(ctx, "Invalid base64 digit");
+      }
+
+      uint8_t piece[4];
+      ::asteria::store_be<uint32_t>(piece, value << 8);
+      ::std::memcpy(optr, piece, out_bytes);
+      optr += out_bytes;
+      bptr += 4;
+    }
+
+    // Drop space for padding characters.
+    bin.erase(static_cast<size_t>(optr - bin.data()));
+  }
+
+// Checks whether a timestamp in milliseconds is within the allowed range.
+constexpr
+bool
+do_is_time_in_range(int64_t count)
+  {
+    return (count >= -2208988800000) && (count <= 253402300799999);
+  }
+
+// Checks whether all bytes of `word` are decimal digits.
+constexpr
+bool
+do_is_eight_digits(uint64_t word)
+  {
+    return ((word & 0xF0F0F0F0F0F0F0F0) | (((word + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4))
+           == 0x3333333333333333;
+  }
+
+// Converts eight decimal digits, which have been loaded in big-endian order, to
+// an integer. Pairs of digits are combined first, then quadruples, then halves,
+// without carries from one lane to another.
+constexpr
+uint32_t
+do_decode_eight_digits(uint64_t word)
+  {
+    word -= 0x3030303030303030;
+    word = (word + (word >> 8) * 10) & 0x00FF00FF00FF00FF;
+    word = (word + (word >> 16) * 100) & 0x0000FFFF0000FFFF;
+    word = word + (word >> 32) * 10000;
+    return static_cast<uint32_t>(word);
+  }
+
+// Decodes a plain decimal integer of no more than 18 digits, which cannot
+// overflow. Other forms, such as those with leading zeroes or prefixes, are left
+// to `ascii_numget`, in which case `false` is returned.
+bool
+do_decode_integer_fast(int64_t& value, const char* str, size_t len)
+  {
+    const char* bptr = str;
+    const char* eptr = str + len;
+    bool neg = (bptr != eptr) && (*bptr == '-');
+    bptr += neg;
+    if((bptr == eptr) || (eptr - bptr > 18) || ((*bptr == '0') && (eptr - bptr > 1)))
+      return false;
+
+    uint64_t acc = 0;
+    while(eptr - bptr >= 8) {
+      uint64_t word = ::asteria::load_be<uint64_t>(bptr);
+      if(!do_is_eight_digits(word))
+        return false;
+
+      acc = acc * 100000000 + do_decode_eight_digits(word);
+      bptr += 8;
+    }
+
+    while(bptr != eptr) {
+      if(!is_within(*bptr, '0', '9'))
+        return false;
+
+      acc = acc * 10 + static_cast<uint32_t>(*bptr - '0');
+      bptr ++;
+    }
+
+    value = static_cast<int64_t>(neg ? (0 - acc) : acc);
+    return true;
+  }
+
+// Multiplies two 64-bit integers, and returns the high half of their product. The
+// low half is stored into `lo`.
+ASTERIA_ALWAYS_INLINE
+uint64_t
+do_multiply_128(uint64_t& lo, uint64_t x, uint64_t y)
+  {
+#ifdef __SIZEOF_INT128__
+    unsigned __int128 prod = static_cast<unsigned __int128>(x) * y;
+    lo = static_cast<uint64_t>(prod);
+    return static_cast<uint64_t>(prod >> 64);
+#else
+    uint64_t ll = (x & UINT32_MAX) * (y & UINT32_MAX);
+    uint64_t lh = (x & UINT32_MAX) * (y >> 32);
+    uint64_t hl = (x >> 32) * (y & UINT32_MAX);
+    uint64_t hh = (x >> 32) * (y >> 32);
+    uint64_t mid = (ll >> 32) + (lh & UINT32_MAX) + (hl & UINT32_MAX);
+    lo = (mid << 32) | (ll & UINT32_MAX);
+    return hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+#endif
+  }
+
+// Converts `mant * 10^exp` to a double with the Eisel-Lemire algorithm. `mant`
+// shall not be zero. The significand is multiplied by a 128-bit approximation of
+// the power of ten, which is precise enough to round correctly, except in rare
+// cases that are detected. Those, and results that are subnormal or infinite,
+// are left to `ascii_numget`, in which case `false` is returned.
+bool
+do_decode_double_eisel_lemire(double& value, uint64_t mant, int exp)
+  {
+    // These are powers of five from 5^-342 to 5^308, shifted so the most
+    // significant bit is set, and truncated to 128 bits. Negative powers are
+    // rounded up instead.
+    static constexpr uint64_t s_pow5[][2] =
+      {
+        { 0xEEF453D6923BD65A, 0x113FAA2906A13B3F }, { 0x9558B4661B6565F8, 0x4AC7CA59A424C507 },
+        { 0xBAAEE17FA23EBF76, 0x5D79BCF00D2DF649 }, { 0xE95A99DF8ACE6F53, 0xF4D82C2C107973DC },
+        { 0x91D8A02BB6C10594, 0x79071B9B8A4BE869 }, { 0xB64EC836A47146F9, 0x9748E2826CDEE284 },
+        { 0xE3E27A444D8D98B7, 0xFD1B1B2308169B25 }, { 0x8E6D8C6AB0787F72, 0xFE30F0F5E50E20F7 },
+        { 0xB208EF855C969F4F, 0xBDBD2D335E51A935 }, { 0xDE8B2B66B3BC4723, 0xAD2C788035E61382 },
+        { 0x8B16FB203055AC76, 0x4C3BCB5021AFCC31 }, { 0xADDCB9E83C6B1793, 0xDF4ABE242A1BBF3D },
+        { 0xD953E8624B85DD78, 0xD71D6DAD34A2AF0D }, { 0x87D4713D6F33AA6B, 0x8672648C40E5AD68 },
+        { 0xA9C98D8CCB009506, 0x680EFDAF511F18C2 }, { 0xD43BF0EFFDC0BA48, 0x0212BD1B2566DEF2 },
+        { 0x84A57695FE98746D, 0x014BB630F7604B57 }, { 0xA5CED43B7E3E9188, 0x419EA3BD35385E2D },
+        { 0xCF42894A5DCE35EA, 0x52064CAC828675B9 }, { 0x818995CE7AA0E1B2, 0x7343EFEBD1940993 },
+        { 0xA1EBFB4219491A1F, 0x1014EBE6C5F90BF8 }, { 0xCA66FA129F9B60A6, 0xD41A26E077774EF6 },
+        { 0xFD00B897478238D0, 0x8920B098955522B4 }, { 0x9E20735E8CB16382, 0x55B46E5F5D5535B0 },
+        { 0xC5A890362FDDBC62, 0xEB2189F734AA831D }, { 0xF712B443BBD52B7B, 0xA5E9EC7501D523E4 },
+        { 0x9A6BB0AA55653B2D, 0x47B233C92125366E }, { 0xC1069CD4EABE89F8, 0x999EC0BB696E840A },
+        { 0xF148440A256E2C76, 0xC00670EA43CA250D }, { 0x96CD2A865764DBCA, 0x380406926A5E5728 },
+        { 0xBC807527ED3E12BC, 0xC605083704F5ECF2 }, { 0xEBA09271E88D976B, 0xF7864A44C633682E },
+        { 0x93445B8731587EA3, 0x7AB3EE6AFBE0211D }, { 0xB8157268FDAE9E4C, 0x5960EA05BAD82964 },
+        { 0xE61ACF033D1A45DF, 0x6FB92487298E33BD }, { 0x8FD0C16206306BAB, 0xA5D3B6D479F8E056 },
+        { 0xB3C4F1BA87BC8696, 0x8F48A4899877186C }, { 0xE0B62E2929ABA83C, 0x331ACDABFE94DE87 },
+        { 0x8C71DCD9BA0B4925, 0x9FF0C08B7F1D0B14 }, { 0xAF8E5410288E1B6F, 0x07ECF0AE5EE44DD9 },
+        { 0xDB71E91432B1A24A, 0xC9E82CD9F69D6150 }, { 0x892731AC9FAF056E, 0xBE311C083A225CD2 },
+        { 0xAB70FE17C79AC6CA, 0x6DBD630A48AAF406 }, { 0xD64D3D9DB981787D, 0x092CBBCCDAD5B108 },
+        { 0x85F0468293F0EB4E, 0x25BBF56008C58EA5 }, { 0xA76C582338ED2621, 0xAF2AF2B80AF6F24E },
+        { 0xD1476E2C07286FAA, 0x1AF5AF660DB4AEE1 }, { 0x82CCA4DB847945CA, 0x50D98D9FC890ED4D },
+        { 0xA37FCE126597973C, 0xE50FF107BAB528A0 }, { 0xCC5FC196FEFD7D0C, 0x1E53ED49A96272C8 },
+        { 0xFF77B1FCBEBCDC4F, 0x25E8E89C13BB0F7A }, { 0x9FAACF3DF73609B1, 0x77B191618C54E9AC },
+        { 0xC795830D75038C1D, 0xD59DF5B9EF6A2417 }, { 0xF97AE3D0D2446F25, 0x4B0573286B44AD1D },
+        { 0x9BECCE62836AC577, 0x4EE367F9430AEC32 }, { 0xC2E801FB244576D5, 0x229C41F793CDA73F },
+        { 0xF3A20279ED56D48A, 0x6B43527578C1110F }, { 0x9845418C345644D6, 0x830A13896B78AAA9 },
+        { 0xBE5691EF416BD60C, 0x23CC986BC656D553 }, { 0xEDEC366B11C6CB8F, 0x2CBFBE86B7EC8AA8 },
+        { 0x94B3A202EB1C3F39, 0x7BF7D71432F3D6A9 }, { 0xB9E08A83A5E34F07, 0xDAF5CCD93FB0CC53 },
+        { 0xE858AD248F5C22C9, 0xD1B3400F8F9CFF68 }, { 0x91376C36D99995BE, 0x23100809B9C21FA1 },
+        { 0xB58547448FFFFB2D, 0xABD40A0C2832A78A }, { 0xE2E69915B3FFF9F9, 0x16C90C8F323F516C },
+        { 0x8DD01FAD907FFC3B, 0xAE3DA7D97F6792E3 }, { 0xB1442798F49FFB4A, 0x99CD11CFDF41779C },
+        { 0xDD95317F31C7FA1D, 0x40405643D711D583 }, { 0x8A7D3EEF7F1CFC52, 0x482835EA666B2572 },
+        { 0xAD1C8EAB5EE43B66, 0xDA3243650005EECF }, { 0xD863B256369D4A40, 0x90BED43E40076A82 },
+        { 0x873E4F75E2224E68, 0x5A7744A6E804A291 }, { 0xA90DE3535AAAE202, 0x711515D0A205CB36 },
+        { 0xD3515C2831559A83, 0x0D5A5B44CA873E03 }, { 0x8412D9991ED58091, 0xE858790AFE9486C2 },
+        { 0xA5178FFF668AE0B6, 0x626E974DBE39A872 }, { 0xCE5D73FF402D98E3, 0xFB0A3D212DC8128F },
+        { 0x80FA687F881C7F8E, 0x7CE66634BC9D0B99 }, { 0xA139029F6A239F72, 0x1C1FFFC1EBC44E80 },
+        { 0xC987434744AC874E, 0xA327FFB266B56220 }, { 0xFBE9141915D7A922, 0x4BF1FF9F0062BAA8 },
+        { 0x9D71AC8FADA6C9B5, 0x6F773FC3603DB4A9 }, { 0xC4CE17B399107C22, 0xCB550FB4384D21D3 },
+        { 0xF6019DA07F549B2B, 0x7E2A53A146606A48 }, { 0x99C102844F94E0FB, 0x2EDA7444CBFC426D },
+        { 0xC0314325637A1939, 0xFA911155FEFB5308 }, { 0xF03D93EEBC589F88, 0x793555AB7EBA27CA },
+        { 0x96267C7535B763B5, 0x4BC1558B2F3458DE }, { 0xBBB01B9283253CA2, 0x9EB1AAEDFB016F16 },
+        { 0xEA9C227723EE8BCB, 0x465E15A979C1CADC }, { 0x92A1958A7675175F, 0x0BFACD89EC191EC9 },
+        { 0xB749FAED14125D36, 0xCEF980EC671F667B }, { 0xE51C79A85916F484, 0x82B7E12780E7401A },
+        { 0x8F31CC0937AE58D2, 0xD1B2ECB8B0908810 }, { 0xB2FE3F0B8599EF07, 0x861FA7E6DCB4AA15 },
+        { 0xDFBDCECE67006AC9, 0x67A791E093E1D49A }, { 0x8BD6A141006042BD, 0xE0C8BB2C5C6D24E0 },
+        { 0xAECC49914078536D, 0x58FAE9F773886E18 }, { 0xDA7F5BF590966848, 0xAF39A475506A899E },
+        { 0x888F99797A5E012D, 0x6D8406C952429603 }, { 0xAAB37FD7D8F58178, 0xC8E5087BA6D33B83 },
+        { 0xD5605FCDCF32E1D6, 0xFB1E4A9A90880A64 }, { 0x855C3BE0A17FCD26, 0x5CF2EEA09A55067F },
+        { 0xA6B34AD8C9DFC06F, 0xF42FAA48C0EA481E }, { 0xD0601D8EFC57B08B, 0xF13B94DAF124DA26 },
+        { 0x823C12795DB6CE57, 0x76C53D08D6B70858 }, { 0xA2CB1717B52481ED, 0x54768C4B0C64CA6E },
+        { 0xCB7DDCDDA26DA268, 0xA9942F5DCF7DFD09 }, { 0xFE5D54150B090B02, 0xD3F93B35435D7C4C },
+        { 0x9EFA548D26E5A6E1, 0xC47BC5014A1A6DAF }, { 0xC6B8E9B0709F109A, 0x359AB6419CA1091B },
+        { 0xF867241C8CC6D4C0, 0xC30163D203C94B62 }, { 0x9B407691D7FC44F8, 0x79E0DE63425DCF1D },
+        { 0xC21094364DFB5636, 0x985915FC12F542E4 }, { 0xF294B943E17A2BC4, 0x3E6F5B7B17B2939D },
+        { 0x979CF3CA6CEC5B5A, 0xA705992CEECF9C42 }, { 0xBD8430BD08277231, 0x50C6FF782A838353 },
+        { 0xECE53CEC4A314EBD, 0xA4F8BF5635246428 }, { 0x940F4613AE5ED136, 0x871B7795E136BE99 },
+        { 0xB913179899F68584, 0x28E2557B59846E3F }, { 0xE757DD7EC07426E5, 0x331AEADA2FE589CF },
+        { 0x9096EA6F3848984F, 0x3FF0D2C85DEF7621 }, { 0xB4BCA50B065ABE63, 0x0FED077A756B53A9 },
+        { 0xE1EBCE4DC7F16DFB, 0xD3E8495912C62894 }, { 0x8D3360F09CF6E4BD, 0x64712DD7ABBBD95C },
+        { 0xB080392CC4349DEC, 0xBD8D794D96AACFB3 }, { 0xDCA04777F541C567, 0xECF0D7A0FC5583A0 },
+        { 0x89E42CAAF9491B60, 0xF41686C49DB57244 }, { 0xAC5D37D5B79B6239, 0x311C2875C522CED5 },
+        { 0xD77485CB25823AC7, 0x7D633293366B828B }, { 0x86A8D39EF77164BC, 0xAE5DFF9C02033197 },
+        { 0xA8530886B54DBDEB, 0xD9F57F830283FDFC }, { 0xD267CAA862A12D66, 0xD072DF63C324FD7B },
+        { 0x8380DEA93DA4BC60, 0x4247CB9E59F71E6D }, { 0xA46116538D0DEB78, 0x52D9BE85F074E608 },
+        { 0xCD795BE870516656, 0x67902E276C921F8B }, { 0x806BD9714632DFF6, 0x00BA1CD8A3DB53B6 },
+        { 0xA086CFCD97BF97F3, 0x80E8A40ECCD228A4 }, { 0xC8A883C0FDAF7DF0, 0x6122CD128006B2CD },
+        { 0xFAD2A4B13D1B5D6C, 0x796B805720085F81 }, { 0x9CC3A6EEC6311A63, 0xCBE3303674053BB0 },
+        { 0xC3F490AA77BD60FC, 0xBEDBFC4411068A9C }, { 0xF4F1B4D515ACB93B, 0xEE92FB5515482D44 },
+        { 0x991711052D8BF3C5, 0x751BDD152D4D1C4A }, { 0xBF5CD54678EEF0B6, 0xD262D45A78A0635D },
+        { 0xEF340A98172AACE4, 0x86FB897116C87C34 }, { 0x9580869F0E7AAC0E, 0xD45D35E6AE3D4DA0 },
+        { 0xBAE0A846D2195712, 0x8974836059CCA109 }, { 0xE998D258869FACD7, 0x2BD1A438703FC94B },
+        { 0x91FF83775423CC06, 0x7B6306A34627DDCF }, { 0xB67F6455292CBF08, 0x1A3BC84C17B1D542 },
+        { 0xE41F3D6A7377EECA, 0x20CABA5F1D9E4A93 }, { 0x8E938662882AF53E, 0x547EB47B7282EE9C },
+        { 0xB23867FB2A35B28D, 0xE99E619A4F23AA43 }, { 0xDEC681F9F4C31F31, 0x6405FA00E2EC94D4 },
+        { 0x8B3C113C38F9F37E, 0xDE83BC408DD3DD04 }, { 0xAE0B158B4738705E, 0x9624AB50B148D445 },
+        { 0xD98DDAEE19068C76, 0x3BADD624DD9B0957 }, { 0x87F8A8D4CFA417C9, 0xE54CA5D70A80E5D6 },
+        { 0xA9F6D30A038D1DBC, 0x5E9FCF4CCD211F4C }, { 0xD47487CC8470652B, 0x7647C3200069671F },
+        { 0x84C8D4DFD2C63F3B, 0x29ECD9F40041E073 }, { 0xA5FB0A17C777CF09, 0xF468107100525890 },
+        { 0xCF79CC9DB955C2CC, 0x7182148D4066EEB4 }, { 0x81AC1FE293D599BF, 0xC6F14CD848405530 },
+        { 0xA21727DB38CB002F, 0xB8ADA00E5A506A7C }, { 0xCA9CF1D206FDC03B, 0xA6D90811F0E4851C },
+        { 0xFD442E4688BD304A, 0x908F4A166D1DA663 }, { 0x9E4A9CEC15763E2E, 0x9A598E4E043287FE },
+        { 0xC5DD44271AD3CDBA, 0x40EFF1E1853F29FD }, { 0xF7549530E188C128, 0xD12BEE59E68EF47C },
+        { 0x9A94DD3E8CF578B9, 0x82BB74F8301958CE }, { 0xC13A148E3032D6E7, 0xE36A52363C1FAF01 },
+        { 0xF18899B1BC3F8CA1, 0xDC44E6C3CB279AC1 }, { 0x96F5600F15A7B7E5, 0x29AB103A5EF8C0B9 },
+        { 0xBCB2B812DB11A5DE, 0x7415D448F6B6F0E7 }, { 0xEBDF661791D60F56, 0x111B495B3464AD21 },
+        { 0x936B9FCEBB25C995, 0xCAB10DD900BEEC34 }, { 0xB84687C269EF3BFB, 0x3D5D514F40EEA742 },
+        { 0xE65829B3046B0AFA, 0x0CB4A5A3112A5112 }, { 0x8FF71A0FE2C2E6DC, 0x47F0E785EABA72AB },
+        { 0xB3F4E093DB73A093, 0x59ED216765690F56 }, { 0xE0F218B8D25088B8, 0x306869C13EC3532C },
+        { 0x8C974F7383725573, 0x1E414218C73A13FB }, { 0xAFBD2350644EEACF, 0xE5D1929EF90898FA },
+        { 0xDBAC6C247D62A583, 0xDF45F746B74ABF39 }, { 0x894BC396CE5DA772, 0x6B8BBA8C328EB783 },
+        { 0xAB9EB47C81F5114F, 0x066EA92F3F326564 }, { 0xD686619BA27255A2, 0xC80A537B0EFEFEBD },
+        { 0x8613FD0145877585, 0xBD06742CE95F5F36 }, { 0xA798FC4196E952E7, 0x2C48113823B73704 },
+        { 0xD17F3B51FCA3A7A0, 0xF75A15862CA504C5 }, { 0x82EF85133DE648C4, 0x9A984D73DBE722FB },
+        { 0xA3AB66580D5FDAF5, 0xC13E60D0D2E0EBBA }, { 0xCC963FEE10B7D1B3, 0x318DF905079926A8 },
+        { 0xFFBBCFE994E5C61F, 0xFDF17746497F7052 }, { 0x9FD561F1FD0F9BD3, 0xFEB6EA8BEDEFA633 },
+        { 0xC7CABA6E7C5382C8, 0xFE64A52EE96B8FC0 }, { 0xF9BD690A1B68637B, 0x3DFDCE7AA3C673B0 },
+        { 0x9C1661A651213E2D, 0x06BEA10CA65C084E }, { 0xC31BFA0FE5698DB8, 0x486E494FCFF30A62 },
+        { 0xF3E2F893DEC3F126, 0x5A89DBA3C3EFCCFA }, { 0x986DDB5C6B3A76B7, 0xF89629465A75E01C },
+        { 0xBE89523386091465, 0xF6BBB397F1135823 }, { 0xEE2BA6C0678B597F, 0x746AA07DED582E2C },
+        { 0x94DB483840B717EF, 0xA8C2A44EB4571CDC }, { 0xBA121A4650E4DDEB, 0x92F34D62616CE413 },
+        { 0xE896A0D7E51E1566, 0x77B020BAF9C81D17 }, { 0x915E2486EF32CD60, 0x0ACE1474DC1D122E },
+        { 0xB5B5ADA8AAFF80B8, 0x0D819992132456BA }, { 0xE3231912D5BF60E6, 0x10E1FFF697ED6C69 },
+        { 0x8DF5EFABC5979C8F, 0xCA8D3FFA1EF463C1 }, { 0xB1736B96B6FD83B3, 0xBD308FF8A6B17CB2 },
+        { 0xDDD0467C64BCE4A0, 0xAC7CB3F6D05DDBDE }, { 0x8AA22C0DBEF60EE4, 0x6BCDF07A423AA96B },
+        { 0xAD4AB7112EB3929D, 0x86C16C98D2C953C6 }, { 0xD89D64D57A607744, 0xE871C7BF077BA8B7 },
+        { 0x87625F056C7C4A8B, 0x11471CD764AD4972 }, { 0xA93AF6C6C79B5D2D, 0xD598E40D3DD89BCF },
+        { 0xD389B47879823479, 0x4AFF1D108D4EC2C3 }, { 0x843610CB4BF160CB, 0xCEDF722A585139BA },
+        { 0xA54394FE1EEDB8FE, 0xC2974EB4EE658828 }, { 0xCE947A3DA6A9273E, 0x733D226229FEEA32 },
+        { 0x811CCC668829B887, 0x0806357D5A3F525F }, { 0xA163FF802A3426A8, 0xCA07C2DCB0CF26F7 },
+        { 0xC9BCFF6034C13052, 0xFC89B393DD02F0B5 }, { 0xFC2C3F3841F17C67, 0xBBAC2078D443ACE2 },
+        { 0x9D9BA7832936EDC0, 0xD54B944B84AA4C0D }, { 0xC5029163F384A931, 0x0A9E795E65D4DF11 },
+        { 0xF64335BCF065D37D, 0x4D4617B5FF4A16D5 }, { 0x99EA0196163FA42E, 0x504BCED1BF8E4E45 },
+        { 0xC06481FB9BCF8D39, 0xE45EC2862F71E1D6 }, { 0xF07DA27A82C37088, 0x5D767327BB4E5A4C },
+        { 0x964E858C91BA2655, 0x3A6A07F8D510F86F }, { 0xBBE226EFB628AFEA, 0x890489F70A55368B },
+        { 0xEADAB0ABA3B2DBE5, 0x2B45AC74CCEA842E }, { 0x92C8AE6B464FC96F, 0x3B0B8BC90012929D },
+        { 0xB77ADA0617E3BBCB, 0x09CE6EBB40173744 }, { 0xE55990879DDCAABD, 0xCC420A6A101D0515 },
+        { 0x8F57FA54C2A9EAB6, 0x9FA946824A12232D }, { 0xB32DF8E9F3546564, 0x47939822DC96ABF9 },
+        { 0xDFF9772470297EBD, 0x59787E2B93BC56F7 }, { 0x8BFBEA76C619EF36, 0x57EB4EDB3C55B65A },
+        { 0xAEFAE51477A06B03, 0xEDE622920B6B23F1 }, { 0xDAB99E59958885C4, 0xE95FAB368E45ECED },
+        { 0x88B402F7FD75539B, 0x11DBCB0218EBB414 }, { 0xAAE103B5FCD2A881, 0xD652BDC29F26A119 },
+        { 0xD59944A37C0752A2, 0x4BE76D3346F0495F }, { 0x857FCAE62D8493A5, 0x6F70A4400C562DDB },
+        { 0xA6DFBD9FB8E5B88E, 0xCB4CCD500F6BB952 }, { 0xD097AD07A71F26B2, 0x7E2000A41346A7A7 },
+        { 0x825ECC24C873782F, 0x8ED400668C0C28C8 }, { 0xA2F67F2DFA90563B, 0x728900802F0F32FA },
+        { 0xCBB41EF979346BCA, 0x4F2B40A03AD2FFB9 }, { 0xFEA126B7D78186BC, 0xE2F610C84987BFA8 },
+        { 0x9F24B832E6B0F436, 0x0DD9CA7D2DF4D7C9 }, { 0xC6EDE63FA05D3143, 0x91503D1C79720DBB },
+        { 0xF8A95FCF88747D94, 0x75A44C6397CE912A }, { 0x9B69DBE1B548CE7C, 0xC986AFBE3EE11ABA },
+        { 0xC24452DA229B021B, 0xFBE85BADCE996168 }, { 0xF2D56790AB41C2A2, 0xFAE27299423FB9C3 },
+        { 0x97C560BA6B0919A5, 0xDCCD879FC967D41A }, { 0xBDB6B8E905CB600F, 0x5400E987BBC1C920 },
+        { 0xED246723473E3813, 0x290123E9AAB23B68 }, { 0x9436C0760C86E30B, 0xF9A0B6720AAF6521 },
+        { 0xB94470938FA89BCE, 0xF808E40E8D5B3E69 }, { 0xE7958CB87392C2C2, 0xB60B1D1230B20E04 },
+        { 0x90BD77F3483BB9B9, 0xB1C6F22B5E6F48C2 }, { 0xB4ECD5F01A4AA828, 0x1E38AEB6360B1AF3 },
+        { 0xE2280B6C20DD5232, 0x25C6DA63C38DE1B0 }, { 0x8D590723948A535F, 0x579C487E5A38AD0E },
+        { 0xB0AF48EC79ACE837, 0x2D835A9DF0C6D851 }, { 0xDCDB1B2798182244, 0xF8E431456CF88E65 },
+        { 0x8A08F0F8BF0F156B, 0x1B8E9ECB641B58FF }, { 0xAC8B2D36EED2DAC5, 0xE272467E3D222F3F },
+        { 0xD7ADF884AA879177, 0x5B0ED81DCC6ABB0F }, { 0x86CCBB52EA94BAEA, 0x98E947129FC2B4E9 },
+        { 0xA87FEA27A539E9A5, 0x3F2398D747B36224 }, { 0xD29FE4B18E88640E, 0x8EEC7F0D19A03AAD },
+        { 0x83A3EEEEF9153E89, 0x1953CF68300424AC }, { 0xA48CEAAAB75A8E2B, 0x5FA8C3423C052DD7 },
+        { 0xCDB02555653131B6, 0x3792F412CB06794D }, { 0x808E17555F3EBF11, 0xE2BBD88BBEE40BD0 },
+        { 0xA0B19D2AB70E6ED6, 0x5B6ACEAEAE9D0EC4 }, { 0xC8DE047564D20A8B, 0xF245825A5A445275 },
+        { 0xFB158592BE068D2E, 0xEED6E2F0F0D56712 }, { 0x9CED737BB6C4183D, 0x55464DD69685606B },
+        { 0xC428D05AA4751E4C, 0xAA97E14C3C26B886 }, { 0xF53304714D9265DF, 0xD53DD99F4B3066A8 },
+        { 0x993FE2C6D07B7FAB, 0xE546A8038EFE4029 }, { 0xBF8FDB78849A5F96, 0xDE98520472BDD033 },
+        { 0xEF73D256A5C0F77C, 0x963E66858F6D4440 }, { 0x95A8637627989AAD, 0xDDE7001379A44AA8 },
+        { 0xBB127C53B17EC159, 0x5560C018580D5D52 }, { 0xE9D71B689DDE71AF, 0xAAB8F01E6E10B4A6 },
+        { 0x9226712162AB070D, 0xCAB3961304CA70E8 }, { 0xB6B00D69BB55C8D1, 0x3D607B97C5FD0D22 },
+        { 0xE45C10C42A2B3B05, 0x8CB89A7DB77C506A }, { 0x8EB98A7A9A5B04E3, 0x77F3608E92ADB242 },
+        { 0xB267ED1940F1C61C, 0x55F038B237591ED3 }, { 0xDF01E85F912E37A3, 0x6B6C46DEC52F6688 },
+        { 0x8B61313BBABCE2C6, 0x2323AC4B3B3DA015 }, { 0xAE397D8AA96C1B77, 0xABEC975E0A0D081A },
+        { 0xD9C7DCED53C72255, 0x96E7BD358C904A21 }, { 0x881CEA14545C7575, 0x7E50D64177DA2E54 },
+        { 0xAA242499697392D2, 0xDDE50BD1D5D0B9E9 }, { 0xD4AD2DBFC3D07787, 0x955E4EC64B44E864 },
+        { 0x84EC3C97DA624AB4, 0xBD5AF13BEF0B113E }, { 0xA6274BBDD0FADD61, 0xECB1AD8AEACDD58E },
+        { 0xCFB11EAD453994BA, 0x67DE18EDA5814AF2 }, { 0x81CEB32C4B43FCF4, 0x80EACF948770CED7 },
+        { 0xA2425FF75E14FC31, 0xA1258379A94D028D }, { 0xCAD2F7F5359A3B3E, 0x096EE45813A04330 },
+        { 0xFD87B5F28300CA0D, 0x8BCA9D6E188853FC }, { 0x9E74D1B791E07E48, 0x775EA264CF55347E },
+        { 0xC612062576589DDA, 0x95364AFE032A819E }, { 0xF79687AED3EEC551, 0x3A83DDBD83F52205 },
+        { 0x9ABE14CD44753B52, 0xC4926A9672793543 }, { 0xC16D9A0095928A27, 0x75B7053C0F178294 },
+        { 0xF1C90080BAF72CB1, 0x5324C68B12DD6339 }, { 0x971DA05074DA7BEE, 0xD3F6FC16EBCA5E04 },
+        { 0xBCE5086492111AEA, 0x88F4BB1CA6BCF585 }, { 0xEC1E4A7DB69561A5, 0x2B31E9E3D06C32E6 },
+        { 0x9392EE8E921D5D07, 0x3AFF322E62439FD0 }, { 0xB877AA3236A4B449, 0x09BEFEB9FAD487C3 },
+        { 0xE69594BEC44DE15B, 0x4C2EBE687989A9B4 }, { 0x901D7CF73AB0ACD9, 0x0F9D37014BF60A11 },
+        { 0xB424DC35095CD80F, 0x538484C19EF38C95 }, { 0xE12E13424BB40E13, 0x2865A5F206B06FBA },
+        { 0x8CBCCC096F5088CB, 0xF93F87B7442E45D4 }, { 0xAFEBFF0BCB24AAFE, 0xF78F69A51539D749 },
+        { 0xDBE6FECEBDEDD5BE, 0xB573440E5A884D1C }, { 0x89705F4136B4A597, 0x31680A88F8953031 },
+        { 0xABCC77118461CEFC, 0xFDC20D2B36BA7C3E }, { 0xD6BF94D5E57A42BC, 0x3D32907604691B4D },
+        { 0x8637BD05AF6C69B5, 0xA63F9A49C2C1B110 }, { 0xA7C5AC471B478423, 0x0FCF80DC33721D54 },
+        { 0xD1B71758E219652B, 0xD3C36113404EA4A9 }, { 0x83126E978D4FDF3B, 0x645A1CAC083126EA },
+        { 0xA3D70A3D70A3D70A, 0x3D70A3D70A3D70A4 }, { 0xCCCCCCCCCCCCCCCC, 0xCCCCCCCCCCCCCCCD },
+        { 0x8000000000000000, 0x0000000000000000 }, { 0xA000000000000000, 0x0000000000000000 },
+        { 0xC800000000000000, 0x0000000000000000 }, { 0xFA00000000000000, 0x0000000000000000 },
+        { 0x9C40000000000000, 0x0000000000000000 }, { 0xC350000000000000, 0x0000000000000000 },
+        { 0xF424000000000000, 0x0000000000000000 }, { 0x9896800000000000, 0x0000000000000000 },
+        { 0xBEBC200000000000, 0x0000000000000000 }, { 0xEE6B280000000000, 0x0000000000000000 },
+        { 0x9502F90000000000, 0x0000000000000000 }, { 0xBA43B74000000000, 0x0000000000000000 },
+        { 0xE8D4A51000000000, 0x0000000000000000 }, { 0x9184E72A00000000, 0x0000000000000000 },
+        { 0xB5E620F480000000, 0x0000000000000000 }, { 0xE35FA931A0000000, 0x0000000000000000 },
+        { 0x8E1BC9BF04000000, 0x0000000000000000 }, { 0xB1A2BC2EC5000000, 0x0000000000000000 },
+        { 0xDE0B6B3A76400000, 0x0000000000000000 }, { 0x8AC7230489E80000, 0x0000000000000000 },
+        { 0xAD78EBC5AC620000, 0x0000000000000000 }, { 0xD8D726B7177A8000, 0x0000000000000000 },
+        { 0x878678326EAC9000, 0x0000000000000000 }, { 0xA968163F0A57B400, 0x0000000000000000 },
+        { 0xD3C21BCECCEDA100, 0x0000000000000000 }, { 0x84595161401484A0, 0x0000000000000000 },
+        { 0xA56FA5B99019A5C8, 0x0000000000000000 }, { 0xCECB8F27F4200F3A, 0x0000000000000000 },
+        { 0x813F3978F8940984, 0x4000000000000000 }, { 0xA18F07D736B90BE5, 0x5000000000000000 },
+        { 0xC9F2C9CD04674EDE, 0xA400000000000000 }, { 0xFC6F7C4045812296, 0x4D00000000000000 },
+        { 0x9DC5ADA82B70B59D, 0xF020000000000000 }, { 0xC5371912364CE305, 0x6C28000000000000 },
+        { 0xF684DF56C3E01BC6, 0xC732000000000000 }, { 0x9A130B963A6C115C, 0x3C7F400000000000 },
+        { 0xC097CE7BC90715B3, 0x4B9F100000000000 }, { 0xF0BDC21ABB48DB20, 0x1E86D40000000000 },
+        { 0x96769950B50D88F4, 0x1314448000000000 }, { 0xBC143FA4E250EB31, 0x17D955A000000000 },
+        { 0xEB194F8E1AE525FD, 0x5DCFAB0800000000 }, { 0x92EFD1B8D0CF37BE, 0x5AA1CAE500000000 },
+        { 0xB7ABC627050305AD, 0xF14A3D9E40000000 }, { 0xE596B7B0C643C719, 0x6D9CCD05D0000000 },
+        { 0x8F7E32CE7BEA5C6F, 0xE4820023A2000000 }, { 0xB35DBF821AE4F38B, 0xDDA2802C8A800000 },
+        { 0xE0352F62A19E306E, 0xD50B2037AD200000 }, { 0x8C213D9DA502DE45, 0x4526F422CC340000 },
+        { 0xAF298D050E4395D6, 0x9670B12B7F410000 }, { 0xDAF3F04651D47B4C, 0x3C0CDD765F114000 },
+        { 0x88D8762BF324CD0F, 0xA5880A69FB6AC800 }, { 0xAB0E93B6EFEE0053, 0x8EEA0D047A457A00 },
+        { 0xD5D238A4ABE98068, 0x72A4904598D6D880 }, { 0x85A36366EB71F041, 0x47A6DA2B7F864750 },
+        { 0xA70C3C40A64E6C51, 0x999090B65F67D924 }, { 0xD0CF4B50CFE20765, 0xFFF4B4E3F741CF6D },
+        { 0x82818F1281ED449F, 0xBFF8F10E7A8921A4 }, { 0xA321F2D7226895C7, 0xAFF72D52192B6A0D },
+        { 0xCBEA6F8CEB02BB39, 0x9BF4F8A69F764490 }, { 0xFEE50B7025C36A08, 0x02F236D04753D5B4 },
+        { 0x9F4F2726179A2245, 0x01D762422C946590 }, { 0xC722F0EF9D80AAD6, 0x424D3AD2B7B97EF5 },
+        { 0xF8EBAD2B84E0D58B, 0xD2E0898765A7DEB2 }, { 0x9B934C3B330C8577, 0x63CC55F49F88EB2F },
+        { 0xC2781F49FFCFA6D5, 0x3CBF6B71C76B25FB }, { 0xF316271C7FC3908A, 0x8BEF464E3945EF7A },
+        { 0x97EDD871CFDA3A56, 0x97758BF0E3CBB5AC }, { 0xBDE94E8E43D0C8EC, 0x3D52EEED1CBEA317 },
+        { 0xED63A231D4C4FB27, 0x4CA7AAA863EE4BDD }, { 0x945E455F24FB1CF8, 0x8FE8CAA93E74EF6A },
+        { 0xB975D6B6EE39E436, 0xB3E2FD538E122B44 }, { 0xE7D34C64A9C85D44, 0x60DBBCA87196B616 },
+        { 0x90E40FBEEA1D3A4A, 0xBC8955E946FE31CD }, { 0xB51D13AEA4A488DD, 0x6BABAB6398BDBE41 },
+        { 0xE264589A4DCDAB14, 0xC696963C7EED2DD1 }, { 0x8D7EB76070A08AEC, 0xFC1E1DE5CF543CA2 },
+        { 0xB0DE65388CC8ADA8, 0x3B25A55F43294BCB }, { 0xDD15FE86AFFAD912, 0x49EF0EB713F39EBE },
+        { 0x8A2DBF142DFCC7AB, 0x6E3569326C784337 }, { 0xACB92ED9397BF996, 0x49C2C37F07965404 },
+        { 0xD7E77A8F87DAF7FB, 0xDC33745EC97BE906 }, { 0x86F0AC99B4E8DAFD, 0x69A028BB3DED71A3 },
+        { 0xA8ACD7C0222311BC, 0xC40832EA0D68CE0C }, { 0xD2D80DB02AABD62B, 0xF50A3FA490C30190 },
+        { 0x83C7088E1AAB65DB, 0x792667C6DA79E0FA }, { 0xA4B8CAB1A1563F52, 0x577001B891185938 },
+        { 0xCDE6FD5E09ABCF26, 0xED4C0226B55E6F86 }, { 0x80B05E5AC60B6178, 0x544F8158315B05B4 },
+        { 0xA0DC75F1778E39D6, 0x696361AE3DB1C721 }, { 0xC913936DD571C84C, 0x03BC3A19CD1E38E9 },
+        { 0xFB5878494ACE3A5F, 0x04AB48A04065C723 }, { 0x9D174B2DCEC0E47B, 0x62EB0D64283F9C76 },
+        { 0xC45D1DF942711D9A, 0x3BA5D0BD324F8394 }, { 0xF5746577930D6500, 0xCA8F44EC7EE36479 },
+        { 0x9968BF6ABBE85F20, 0x7E998B13CF4E1ECB }, { 0xBFC2EF456AE276E8, 0x9E3FEDD8C321A67E },
+        { 0xEFB3AB16C59B14A2, 0xC5CFE94EF3EA101E }, { 0x95D04AEE3B80ECE5, 0xBBA1F1D158724A12 },
+        { 0xBB445DA9CA61281F, 0x2A8A6E45AE8EDC97 }, { 0xEA1575143CF97226, 0xF52D09D71A3293BD },
+        { 0x924D692CA61BE758, 0x593C2626705F9C56 }, { 0xB6E0C377CFA2E12E, 0x6F8B2FB00C77836C },
+        { 0xE498F455C38B997A, 0x0B6DFB9C0F956447 }, { 0x8EDF98B59A373FEC, 0x4724BD4189BD5EAC },
+        { 0xB2977EE300C50FE7, 0x58EDEC91EC2CB657 }, { 0xDF3D5E9BC0F653E1, 0x2F2967B66737E3ED },
+        { 0x8B865B215899F46C, 0xBD79E0D20082EE74 }, { 0xAE67F1E9AEC07187, 0xECD8590680A3AA11 },
+        { 0xDA01EE641A708DE9, 0xE80E6F4820CC9495 }, { 0x884134FE908658B2, 0x3109058D147FDCDD },
+        { 0xAA51823E34A7EEDE, 0xBD4B46F0599FD415 }, { 0xD4E5E2CDC1D1EA96, 0x6C9E18AC7007C91A },
+        { 0x850FADC09923329E, 0x03E2CF6BC604DDB0 }, { 0xA6539930BF6BFF45, 0x84DB8346B786151C },
+        { 0xCFE87F7CEF46FF16, 0xE612641865679A63 }, { 0x81F14FAE158C5F6E, 0x4FCB7E8F3F60C07E },
+        { 0xA26DA3999AEF7749, 0xE3BE5E330F38F09D }, { 0xCB090C8001AB551C, 0x5CADF5BFD3072CC5 },
+        { 0xFDCB4FA002162A63, 0x73D9732FC7C8F7F6 }, { 0x9E9F11C4014DDA7E, 0x2867E7FDDCDD9AFA },
+        { 0xC646D63501A1511D, 0xB281E1FD541501B8 }, { 0xF7D88BC24209A565, 0x1F225A7CA91A4226 },
+        { 0x9AE757596946075F, 0x3375788DE9B06958 }, { 0xC1A12D2FC3978937, 0x0052D6B1641C83AE },
+        { 0xF209787BB47D6B84, 0xC0678C5DBD23A49A }, { 0x9745EB4D50CE6332, 0xF840B7BA963646E0 },
+        { 0xBD176620A501FBFF, 0xB650E5A93BC3D898 }, { 0xEC5D3FA8CE427AFF, 0xA3E51F138AB4CEBE },
+        { 0x93BA47C980E98CDF, 0xC66F336C36B10137 }, { 0xB8A8D9BBE123F017, 0xB80B0047445D4184 },
+        { 0xE6D3102AD96CEC1D, 0xA60DC059157491E5 }, { 0x9043EA1AC7E41392, 0x87C89837AD68DB2F },
+        { 0xB454E4A179DD1877, 0x29BABE4598C311FB }, { 0xE16A1DC9D8545E94, 0xF4296DD6FEF3D67A },
+        { 0x8CE2529E2734BB1D, 0x1899E4A65F58660C }, { 0xB01AE745B101E9E4, 0x5EC05DCFF72E7F8F },
+        { 0xDC21A1171D42645D, 0x76707543F4FA1F73 }, { 0x899504AE72497EBA, 0x6A06494A791C53A8 },
+        { 0xABFA45DA0EDBDE69, 0x0487DB9D17636892 }, { 0xD6F8D7509292D603, 0x45A9D2845D3C42B6 },
+        { 0x865B86925B9BC5C2, 0x0B8A2392BA45A9B2 }, { 0xA7F26836F282B732, 0x8E6CAC7768D7141E },
+        { 0xD1EF0244AF2364FF, 0x3207D795430CD926 }, { 0x8335616AED761F1F, 0x7F44E6BD49E807B8 },
+        { 0xA402B9C5A8D3A6E7, 0x5F16206C9C6209A6 }, { 0xCD036837130890A1, 0x36DBA887C37A8C0F },
+        { 0x802221226BE55A64, 0xC2494954DA2C9789 }, { 0xA02AA96B06DEB0FD, 0xF2DB9BAA10B7BD6C },
+        { 0xC83553C5C8965D3D, 0x6F92829494E5ACC7 }, { 0xFA42A8B73ABBF48C, 0xCB772339BA1F17F9 },
+        { 0x9C69A97284B578D7, 0xFF2A760414536EFB }, { 0xC38413CF25E2D70D, 0xFEF5138519684ABA },
+        { 0xF46518C2EF5B8CD1, 0x7EB258665FC25D69 }, { 0x98BF2F79D5993802, 0xEF2F773FFBD97A61 },
+        { 0xBEEEFB584AFF8603, 0xAAFB550FFACFD8FA }, { 0xEEAABA2E5DBF6784, 0x95BA2A53F983CF38 },
+        { 0x952AB45CFA97A0B2, 0xDD945A747BF26183 }, { 0xBA756174393D88DF, 0x94F971119AEEF9E4 },
+        { 0xE912B9D1478CEB17, 0x7A37CD5601AAB85D }, { 0x91ABB422CCB812EE, 0xAC62E055C10AB33A },
+        { 0xB616A12B7FE617AA, 0x577B986B314D6009 }, { 0xE39C49765FDF9D94, 0xED5A7E85FDA0B80B },
+        { 0x8E41ADE9FBEBC27D, 0x14588F13BE847307 }, { 0xB1D219647AE6B31C, 0x596EB2D8AE258FC8 },
+        { 0xDE469FBD99A05FE3, 0x6FCA5F8ED9AEF3BB }, { 0x8AEC23D680043BEE, 0x25DE7BB9480D5854 },
+        { 0xADA72CCC20054AE9, 0xAF561AA79A10AE6A }, { 0xD910F7FF28069DA4, 0x1B2BA1518094DA04 },
+        { 0x87AA9AFF79042286, 0x90FB44D2F05D0842 }, { 0xA99541BF57452B28, 0x353A1607AC744A53 },
+        { 0xD3FA922F2D1675F2, 0x42889B8997915CE8 }, { 0x847C9B5D7C2E09B7, 0x69956135FEBADA11 },
+        { 0xA59BC234DB398C25, 0x43FAB9837E699095 }, { 0xCF02B2C21207EF2E, 0x94F967E45E03F4BB },
+        { 0x8161AFB94B44F57D, 0x1D1BE0EEBAC278F5 }, { 0xA1BA1BA79E1632DC, 0x6462D92A69731732 },
+        { 0xCA28A291859BBF93, 0x7D7B8F7503CFDCFE }, { 0xFCB2CB35E702AF78, 0x5CDA735244C3D43E },
+        { 0x9DEFBF01B061ADAB, 0x3A0888136AFA64A7 }, { 0xC56BAEC21C7A1916, 0x088AAA1845B8FDD0 },
+        { 0xF6C69A72A3989F5B, 0x8AAD549E57273D45 }, { 0x9A3C2087A63F6399, 0x36AC54E2F678864B },
+        { 0xC0CB28A98FCF3C7F, 0x84576A1BB416A7DD }, { 0xF0FDF2D3F3C30B9F, 0x656D44A2A11C51D5 },
+        { 0x969EB7C47859E743, 0x9F644AE5A4B1B325 }, { 0xBC4665B596706114, 0x873D5D9F0DDE1FEE },
+        { 0xEB57FF22FC0C7959, 0xA90CB506D155A7EA }, { 0x9316FF75DD87CBD8, 0x09A7F12442D588F2 },
+        { 0xB7DCBF5354E9BECE, 0x0C11ED6D538AEB2F }, { 0xE5D3EF282A242E81, 0x8F1668C8A86DA5FA },
+        { 0x8FA475791A569D10, 0xF96E017D694487BC }, { 0xB38D92D760EC4455, 0x37C981DCC395A9AC },
+        { 0xE070F78D3927556A, 0x85BBE253F47B1417 }, { 0x8C469AB843B89562, 0x93956D7478CCEC8E },
+        { 0xAF58416654A6BABB, 0x387AC8D1970027B2 }, { 0xDB2E51BFE9D0696A, 0x06997B05FCC0319E },
+        { 0x88FCF317F22241E2, 0x441FECE3BDF81F03 }, { 0xAB3C2FDDEEAAD25A, 0xD527E81CAD7626C3 },
+        { 0xD60B3BD56A5586F1, 0x8A71E223D8D3B074 }, { 0x85C7056562757456, 0xF6872D5667844E49 },
+        { 0xA738C6BEBB12D16C, 0xB428F8AC016561DB }, { 0xD106F86E69D785C7, 0xE13336D701BEBA52 },
+        { 0x82A45B450226B39C, 0xECC0024661173473 }, { 0xA34D721642B06084, 0x27F002D7F95D0190 },
+        { 0xCC20CE9BD35C78A5, 0x31EC038DF7B441F4 }, { 0xFF290242C83396CE, 0x7E67047175A15271 },
+        { 0x9F79A169BD203E41, 0x0F0062C6E984D386 }, { 0xC75809C42C684DD1, 0x52C07B78A3E60868 },
+        { 0xF92E0C3537826145, 0xA7709A56CCDF8A82 }, { 0x9BBCC7A142B17CCB, 0x88A66076400BB691 },
+        { 0xC2ABF989935DDBFE, 0x6ACFF893D00EA435 }, { 0xF356F7EBF83552FE, 0x0583F6B8C4124D43 },
+        { 0x98165AF37B2153DE, 0xC3727A337A8B704A }, { 0xBE1BF1B059E9A8D6, 0x744F18C0592E4C5C },
+        { 0xEDA2EE1C7064130C, 0x1162DEF06F79DF73 }, { 0x9485D4D1C63E8BE7, 0x8ADDCB5645AC2BA8 },
+        { 0xB9A74A0637CE2EE1, 0x6D953E2BD7173692 }, { 0xE8111C87C5C1BA99, 0xC8FA8DB6CCDD0437 },
+        { 0x910AB1D4DB9914A0, 0x1D9C9892400A22A2 }, { 0xB54D5E4A127F59C8, 0x2503BEB6D00CAB4B },
+        { 0xE2A0B5DC971F303A, 0x2E44AE64840FD61D }, { 0x8DA471A9DE737E24, 0x5CEAECFED289E5D2 },
+        { 0xB10D8E1456105DAD, 0x7425A83E872C5F47 }, { 0xDD50F1996B947518, 0xD12F124E28F77719 },
+        { 0x8A5296FFE33CC92F, 0x82BD6B70D99AAA6F }, { 0xACE73CBFDC0BFB7B, 0x636CC64D1001550B },
+        { 0xD8210BEFD30EFA5A, 0x3C47F7E05401AA4E }, { 0x8714A775E3E95C78, 0x65ACFAEC34810A71 },
+        { 0xA8D9D1535CE3B396, 0x7F1839A741A14D0D }, { 0xD31045A8341CA07C, 0x1EDE48111209A050 },
+        { 0x83EA2B892091E44D, 0x934AED0AAB460432 }, { 0xA4E4B66B68B65D60, 0xF81DA84D5617853F },
+        { 0xCE1DE40642E3F4B9, 0x36251260AB9D668E }, { 0x80D2AE83E9CE78F3, 0xC1D72B7C6B426019 },
+        { 0xA1075A24E4421730, 0xB24CF65B8612F81F }, { 0xC94930AE1D529CFC, 0xDEE033F26797B627 },
+        { 0xFB9B7CD9A4A7443C, 0x169840EF017DA3B1 }, { 0x9D412E0806E88AA5, 0x8E1F289560EE864E },
+        { 0xC491798A08A2AD4E, 0xF1A6F2BAB92A27E2 }, { 0xF5B5D7EC8ACB58A2, 0xAE10AF696774B1DB },
+        { 0x9991A6F3D6BF1765, 0xACCA6DA1E0A8EF29 }, { 0xBFF610B0CC6EDD3F, 0x17FD090A58D32AF3 },
+        { 0xEFF394DCFF8A948E, 0xDDFC4B4CEF07F5B0 }, { 0x95F83D0A1FB69CD9, 0x4ABDAF101564F98E },
+        { 0xBB764C4CA7A4440F, 0x9D6D1AD41ABE37F1 }, { 0xEA53DF5FD18D5513, 0x84C86189216DC5ED },
+        { 0x92746B9BE2F8552C, 0x32FD3CF5B4E49BB4 }, { 0xB7118682DBB66A77, 0x3FBC8C33221DC2A1 },
+        { 0xE4D5E82392A40515, 0x0FABAF3FEAA5334A }, { 0x8F05B1163BA6832D, 0x29CB4D87F2A7400E },
+        { 0xB2C71D5BCA9023F8, 0x743E20E9EF511012 }, { 0xDF78E4B2BD342CF6, 0x914DA9246B255416 },
+        { 0x8BAB8EEFB6409C1A, 0x1AD089B6C2F7548E }, { 0xAE9672ABA3D0C320, 0xA184AC2473B529B1 },
+        { 0xDA3C0F568CC4F3E8, 0xC9E5D72D90A2741E }, { 0x8865899617FB1871, 0x7E2FA67C7A658892 },
+        { 0xAA7EEBFB9DF9DE8D, 0xDDBB901B98FEEAB7 }, { 0xD51EA6FA85785631, 0x552A74227F3EA565 },
+        { 0x8533285C936B35DE, 0xD53A88958F87275F }, { 0xA67FF273B8460356, 0x8A892ABAF368F137 },
+        { 0xD01FEF10A657842C, 0x2D2B7569B0432D85 }, { 0x8213F56A67F6B29B, 0x9C3B29620E29FC73 },
+        { 0xA298F2C501F45F42, 0x8349F3BA91B47B8F }, { 0xCB3F2F7642717713, 0x241C70A936219A73 },
+        { 0xFE0EFB53D30DD4D7, 0xED238CD383AA0110 }, { 0x9EC95D1463E8A506, 0xF4363804324A40AA },
+        { 0xC67BB4597CE2CE48, 0xB143C6053EDCD0D5 }, { 0xF81AA16FDC1B81DA, 0xDD94B7868E94050A },
+        { 0x9B10A4E5E9913128, 0xCA7CF2B4191C8326 }, { 0xC1D4CE1F63F57D72, 0xFD1C2F611F63A3F0 },
+        { 0xF24A01A73CF2DCCF, 0xBC633B39673C8CEC }, { 0x976E41088617CA01, 0xD5BE0503E085D813 },
+        { 0xBD49D14AA79DBC82, 0x4B2D8644D8A74E18 }, { 0xEC9C459D51852BA2, 0xDDF8E7D60ED1219E },
+        { 0x93E1AB8252F33B45, 0xCABB90E5C942B503 }, { 0xB8DA1662E7B00A17, 0x3D6A751F3B936243 },
+        { 0xE7109BFBA19C0C9D, 0x0CC512670A783AD4 }, { 0x906A617D450187E2, 0x27FB2B80668B24C5 },
+        { 0xB484F9DC9641E9DA, 0xB1F9F660802DEDF6 }, { 0xE1A63853BBD26451, 0x5E7873F8A0396973 },
+        { 0x8D07E33455637EB2, 0xDB0B487B6423E1E8 }, { 0xB049DC016ABC5E5F, 0x91CE1A9A3D2CDA62 },
+        { 0xDC5C5301C56B75F7, 0x7641A140CC7810FB }, { 0x89B9B3E11B6329BA, 0xA9E904C87FCB0A9D },
+        { 0xAC2820D9623BF429, 0x546345FA9FBDCD44 }, { 0xD732290FBACAF133, 0xA97C177947AD4095 },
+        { 0x867F59A9D4BED6C0, 0x49ED8EABCCCC485D }, { 0xA81F301449EE8C70, 0x5C68F256BFFF5A74 },
+        { 0xD226FC195C6A2F8C, 0x73832EEC6FFF3111 }, { 0x83585D8FD9C25DB7, 0xC831FD53C5FF7EAB },
+        { 0xA42E74F3D032F525, 0xBA3E7CA8B77F5E55 }, { 0xCD3A1230C43FB26F, 0x28CE1BD2E55F35EB },
+        { 0x80444B5E7AA7CF85, 0x7980D163CF5B81B3 }, { 0xA0555E361951C366, 0xD7E105BCC332621F },
+        { 0xC86AB5C39FA63440, 0x8DD9472BF3FEFAA7 }, { 0xFA856334878FC150, 0xB14F98F6F0FEB951 },
+        { 0x9C935E00D4B9D8D2, 0x6ED1BF9A569F33D3 }, { 0xC3B8358109E84F07, 0x0A862F80EC4700C8 },
+        { 0xF4A642E14C6262C8, 0xCD27BB612758C0FA }, { 0x98E7E9CCCFBD7DBD, 0x8038D51CB897789C },
+        { 0xBF21E44003ACDD2C, 0xE0470A63E6BD56C3 }, { 0xEEEA5D5004981478, 0x1858CCFCE06CAC74 },
+        { 0x95527A5202DF0CCB, 0x0F37801E0C43EBC8 }, { 0xBAA718E68396CFFD, 0xD30560258F54E6BA },
+        { 0xE950DF20247C83FD, 0x47C6B82EF32A2069 }, { 0x91D28B7416CDD27E, 0x4CDC331D57FA5441 },
+        { 0xB6472E511C81471D, 0xE0133FE4ADF8E952 }, { 0xE3D8F9E563A198E5, 0x58180FDDD97723A6 },
+        { 0x8E679C2F5E44FF8F, 0x570F09EAA7EA7648 },
+      };
+
+    if(!is_within(exp, -342, 308))
+      return false;
+
+    // Normalize the significand, and multiply it with the high half of the power
+    // of five. If the bits below the 55 bits that are needed for rounding are
+    // all ones, a carry from the low half may reach them, so add that too.
+    int lz = static_cast<int>(::asteria::lzcnt64(mant));
+    uint64_t w = mant << lz;
+    const uint64_t* pow5 = s_pow5[exp + 342];
+    uint64_t lo;
+    uint64_t hi = do_multiply_128(lo, w, pow5[0]);
+    if((hi & 0x1FF) == 0x1FF) {
+      uint64_t lo2;
+      uint64_t hi2 = do_multiply_128(lo2, w, pow5[1]);
+      lo += hi2;
+      hi += (lo < hi2);
+    }
+
+    if((lo == UINT64_MAX) && !is_within(exp, -27, 55))
+      return false;
+
+    // Take 53 bits and a rounding bit. The binary exponent of 10^exp is
+    // `floor(exp * log2(10))`, which is approximated with a multiplication.
+    int upper = static_cast<int>(hi >> 63);
+    int shift = upper + 9;
+    uint64_t bits = hi >> shift;
+    int power2 = ((217706 * exp) >> 16) + 63 + upper - lz + 1023;
+    if(power2 <= 0)
+      return false;
+
+    // If the product is exact and halfway between two doubles, round it to even.
+    // This is only possible for small exponents.
+    if((lo <= 1) && is_within(exp, -4, 23) && ((bits & 3) == 1) && ((bits << shift) == hi))
+      bits &= ~uint64_t(1);
+
+    bits += bits & 1;
+    bits >>= 1;
+    if(bits >> 53) {
+      bits >>= 1;
+      power2 ++;
+    }
+
+    if(power2 >= 0x7FF)
+      return false;
+
+    bits &= ~(uint64_t(1) << 52);
+    bits |= static_cast<uint64_t>(power2) << 52;
+    ::std::memcpy(&value, &bits, sizeof(value));
+    return true;
+  }
+
+// Decodes a decimal floating-point number, if its significand has no more than
+// 19 digits. If the significand has no more than 53 bits, and the magnitude of
+// the decimal exponent is no more than 22, both are exact in double precision,
+// so a single multiplication or division yields a correctly rounded result.
+// This is the fast path of Clinger's algorithm. Other numbers, such as those
+// with 17 digits which are printed for most doubles, are converted with the
+// Eisel-Lemire algorithm. Other forms are left to `ascii_numget`, in which case
+// `false` is returned.
+bool
+do_decode_double_fast(double& value, const char* str, size_t len)
+  {
+    static constexpr double s_pow10[] =
+      {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+      };
+
+    const char* bptr = str;
+    const char* eptr = str + len;
+    bool neg = (bptr != eptr) && (*bptr == '-');
+    bptr += (bptr != eptr) && is_any(*bptr, '+', '-');
+
+    // Take the significand. Digits after the decimal point are counted into the
+    // exponent. Leading zeroes are not significant. The significand overflows
+    // only if a digit is appended to a value with 19 digits.
+    uint64_t mant = 0;
+    bool ovf = false;
+    int exp = 0;
+    const char* mptr = bptr;
+    while((bptr != eptr) && is_within(*bptr, '0', '9')) {
+      ovf |= mant >= 1000000000000000000;
+      mant = mant * 10 + static_cast<uint32_t>(*bptr - '0');
+      bptr ++;
+    }
+
+    if(bptr == mptr)
+      return false;
+
+    if((bptr != eptr) && (*bptr == '.')) {
+      bptr ++;
+      mptr = bptr;
+      while((eptr - bptr >= 8) && (mant < 100000000000)) {
+        uint64_t word = ::asteria::load_be<uint64_t>(bptr);
+        if(!do_is_eight_digits(word))
+          break;
+
+        mant = mant * 100000000 + do_decode_eight_digits(word);
+        bptr += 8;
+      }
+
+      while((bptr != eptr) && is_within(*bptr, '0', '9')) {
+        ovf |= mant >= 1000000000000000000;
+        mant = mant * 10 + static_cast<uint32_t>(*bptr - '0');
+        bptr ++;
+      }
+
+      if((bptr == mptr) || (bptr - mptr > 1000))
+        return false;
+
+      exp = static_cast<int>(mptr - bptr);
+    }
+
+    if(ovf)
+      return false;
+
+    if((bptr != eptr) && is_any(*bptr, 'e', 'E')) {
+      bptr ++;
+      bool eneg = (bptr != eptr) && (*bptr == '-');
+      bptr += (bptr != eptr) && is_any(*bptr, '+', '-');
+
+      mptr = bptr;
+      int eabs = 0;
+      while((bptr != eptr) && is_within(*bptr, '0', '9') && (eabs < 1000)) {
+        eabs = eabs * 10 + (*bptr - '0');
+        bptr ++;
+      }
+
+      if(bptr == mptr)
+        return false;
+
+      exp += eneg ? -eabs : eabs;
+    }
+
+    if(bptr != eptr)
+      return false;
+
+    // Intermediate results must not be kept in extended precision.
+    double temp = 0;
+    if(mant == 0)
+      temp = 0;
+    else if((FLT_EVAL_METHOD == 0) && (mant <= (uint64_t(1) << 53)) && is_within(exp, 0, 22))
+      temp = static_cast<double>(mant) * s_pow10[exp];
+    else if((FLT_EVAL_METHOD == 0) && (mant <= (uint64_t(1) << 53)) && is_within(exp, -22, -1))
+      temp = static_cast<double>(mant) / s_pow10[-exp];
+    else if(!do_decode_double_eisel_lemire(temp, mant, exp))
+      return false;
+
+    value = neg ? -temp : temp;
+    return true;
+  }
+
+// Decodes a scalar token, and passes its value to `handler`. Binary data are
+// decoded into `bin`, which is reused for all tokens.
+template<typename xHandler>
+void
+do_emit_scalar(xHandler& handler, Parser_Context& ctx, const Parser_Token& token,
+               ::asteria::ascii_numget& numg, V_binary& bin, Options opts)
+  {
+    if(is_any(token[0], '+', '-') || is_within(token[0], '0', '9')) {
+      // number
+      double value;
+      if(!do_decode_double_fast(value, token.data(), token.size())) {
+        size_t n = numg.parse_DD(token.data(), token.size());
+        ASTERIA_ASSERT(n == token.size());
+        numg.cast_D(value, -DBL_MAX, DBL_MAX);
+        if(numg.overflowed())
+          return do_err(ctx, "Number out of range");
+      }
+
+      handler.on_number(value);
+    }
+    else if(token[0] == '\"') {
+      // string
+      if((opts & option_json_mode) || (token[1] != '$')) {
+        // plain
+        handler.on_string(token.data() + 1, token.size() - 1);
+      }
+      else if((token[2] == 'l') && (token[3] == ':')) {
+        // 64-bit integer
+        int64_t value;
+        if(!do_decode_integer_fast(value, token.data() + 4, token.size() - 4)) {
+          if(numg.parse_I(token.data() + 4, token.size() - 4) != token.size() - 4)
+            return do_err(ctx, "Invalid 64-bit integer");
+
+          numg.cast_I(value, INT64_MIN, INT64_MAX);
+          if(numg.overflowed())
+            return do_err(ctx, "64-bit integer value out of range");
+        }
+
+        handler.on_integer(value);
+      }
+      else if((token[2] == 'd') && (token[3] == ':')) {
+        // double-precision number
+        double value;
+        if(!do_decode_double_fast(value, token.data() + 4, token.size() - 4)) {
+          if(numg.parse_D(token.data() + 4, token.size() - 4) != token.size() - 4)
+            return do_err(ctx, "Invalid double-precision number");
+
+          // Values that are out of range are converted to infinities and are
+          // always accepted.
+          numg.cast_D(value, -HUGE_VAL, HUGE_VAL);
+        }
+        handler.on_number(value);
+      }
+      else if((token[2] == 's') && (token[3] == ':')) {
+        // annotated string
+        handler.on_string(token.data() + 4, token.size() - 4);
+      }
+      else if((token[2] == 't') && (token[3] == ':')) {
+        // timestamp in milliseconds
+        // The allowed timestamp values are from '1900-01-01T00:00:00.000Z' to
+        // '9999-12-31T23:59:59.999Z'.
+        int64_t count;
+        if(!do_decode_integer_fast(count, token.data() + 4, token.size() - 4)
+           || !do_is_time_in_range(count)) {
+          if(numg.parse_I(token.data() + 4, token.size() - 4) != token.size() - 4)
+            return do_err(ctx, "Invalid timestamp");
+
+          numg.cast_I(count, -2208988800000, 253402300799999);
+          if(numg.overflowed())
+            return do_err(ctx, "Timestamp value out of range");
+        }
+
+        handler.on_time(V_time(::std::chrono::milliseconds(count)));
+      }
+      else if((token[2] == 'h') && (token[3] == ':')) {
+        // hex-encoded data
+        do_decode_hex(bin, ctx, token.data() + 4, token.size() - 4);
+        if(ctx.error)
+          return;
+
+        handler.on_binary(bin.data(), bin.size());
+      }
+      else if((token[2] == 'b') && (token[3] == ':')) {
+        // base64-encoded data
+        do_decode_base64(bin, ctx, token.data() + 4, token.size() - 4);
+        if(ctx.error)
+          return;
+
+        handler.on_binary(bin.data(), bin.size());
+      }
+      else
+        return do_err(ctx, "Unknown type annotator");
+    }
+    else if(token.equals("null", 4))
+      handler.on_null();
+    else if(token.equals("true", 4))
+      handler.on_boolean(true);
+    else if(token.equals("false", 5))
+      handler.on_boolean(false);
+    else
+      return do_err(ctx, "Invalid token");
+  }
+
+// This handler stores a scalar into a value, so `do_parse_scalar()` can share the
+// decoder of the event parser. Binary data have been decoded into `*pbin`, so
+// they are moved instead of copied.
+struct Scalar_Storer
+  {
+    Value* pstor;
+    V_binary* pbin;
+
+    void
+    on_null()
+      { this->pstor->clear();  }
+
+    void
+    on_boolean(bool value)
+      { this->pstor->open_boolean() = value;  }
+
+    void
+    on_integer(int64_t value)
+      { this->pstor->open_integer() = value;  }
+
+    void
+    on_number(double value)
+      { this->pstor->open_number() = value;  }
+
+    void
+    on_string(const char* str, size_t len)
+      { this->pstor->open_string().assign(str, len);  }
+
+    void
+    on_binary(const unsigned char* /*data*/, size_t /*size*/)
+      { this->pstor->open_binary().swap(*(this->pbin));  }
+
+    void
+    on_time(V_time value)
+      { this->pstor->open_time() = value;  }
+  };
+
+// Decodes a scalar token, and stores its value into `stor`. Arrays and objects
+// are handled by the caller.
+void
+do_parse_scalar(Value& stor, Parser_Context& ctx, const Parser_Token& token,
+                ::asteria::ascii_numget& numg, Options opts)
+  {
+    V_binary bin;
+    Scalar_Storer storer = { &stor, &bin };
+    do_emit_scalar(storer, ctx, token, numg, bin, opts);
+  }
+
+// These are buffers of the parser. They are reused when multiple values are
+// parsed from the same source.
+struct Parser_Workspace
+  {
+    // Break deep recursion with a handwritten stack.
+    struct xFrame
+      {
+        Value* target;
+        V_array* psa;
+        V_object* pso;
+      };
+
+    ::std::vector<xFrame> stack;
+    Parser_Token token;
+    ::asteria::ascii_numget numg;
+    Key_Pool key_pool;
+    ::std::vector<::std::vector<::asteria::phcow_string>> shapes;  // keys by level
+    Structural_Index index;
+    size_t depth = 0;  // levels of nesting outside the value being parsed
+    Key_Dictionary* dict = nullptr;
+  };
+
+template<typename xSource>
+void
+do_prepare_source(xSource& usrc, Parser_Workspace& work)
+  {
+    if constexpr(::std::is_same<xSource, Memory_Source>::value
+                 || ::std::is_same<xSource, Chunk_Source>::value)
+      if(static_cast<uint64_t>(usrc.eptr - usrc.bptr) <= UINT32_MAX) {
+        // Build a structural index for the second stage as it proceeds.
+        do_reset_index(work.index, usrc.bptr, usrc.eptr);
+        usrc.index = &(work.index);
+        usrc.iptr = nullptr;
+        usrc.ieptr = nullptr;
+      }
+  }
+
+// Gets the number of elements or members of the array or object whose open
+// bracket or brace has just been taken, or zero if it is unknown.
+template<typename xSource>
+size_t
+do_next_count(xSource& usrc)
+  {
+    if constexpr(is_memory_source<xSource>)
+      if(usrc.index && (usrc.iptr != usrc.index->offsets.data())) {
+        auto& idx = *(usrc.index);
+        size_t pos = static_cast<size_t>(usrc.iptr - idx.offsets.data()) - 1;
+        if(idx.bptr + idx.offsets[pos] != usrc.sptr - 1)
+          return 0;
+
+        // If the array or object is not closed in the indexed part of input,
+        // index more, but not too far.
+        if(idx.counts[pos] == Structural_Index::npos) {
+          while((idx.counts[pos] == Structural_Index::npos)
+                && (static_cast<size_t>(idx.sptr - usrc.sptr) < Structural_Index::lookahead_size)
+                && do_extend_index(idx));
+
+          usrc.iptr = idx.offsets.data() + pos + 1;
+          usrc.ieptr = idx.offsets.data() + idx.offsets.size();
+          if(idx.counts[pos] == Structural_Index::npos)
+            return 0;
+        }
+
+        return idx.counts[pos];
+      }
+
+    return 0;
+  }
+
+// These are states of the parser, which is driven by tokens. Each denotes the
+// token that is expected.
+enum : uint32_t
+  {
+    state_value          = 0,  // a value
+    state_array_open     = 1,  // a value or `]` after `[`
+    state_object_open    = 2,  // a key or `}` after `{`
+    state_colon          = 3,  // `:` after a key
+    state_next           = 4,  // `,` or a closing bracket or brace
+    state_array_comma    = 5,  // a value after `,` in an array
+    state_object_comma   = 6,  // a key after `,` in an object
+    state_done           = 7,  // nothing; the value has been completed
+    state_error          = 8,  // nothing; an error has occurred
+  };
+
+// Parses tokens from `state`, which has been taken into `token`. Syntax is
+// checked here, and values are made by `b`, which is a tree, tape or event
+// builder with these members:
+//
+//   depth()      gets the level of nesting, for the nesting limit
+//   at_top()     checks whether no array or object is open
+//   in_array()   checks whether the innermost open one is an array
+//   do_value()   is called with the first token of a value; if it returns
+//                `false`, the value has been taken from the source by `b`
+//   do_start(o)  is called after `[` (o = false) or `{` (o = true)
+//   do_empty(o)  is called after `]` or `}` that closes an empty one
+//   do_push(o)   is called before the first element or member
+//   do_element() is called with the first token of an element; if it returns
+//                `false`, the element has been skipped by `b`
+//   do_member()  is called with a key; if it returns `false`, the colon and the
+//                value have been skipped by `b`
+//   do_scalar()  is called with a scalar value
+//   do_pop()     is called after `]` or `}` that closes a non-empty one
+//
+// Hooks report errors with `do_err()`. The next token is taken by `next()`. If
+// it returns `false`, the state in which parsing shall be resumed is returned,
+// which is how a push parser waits for more input.
+//
+// Builders on hot paths refer to their stacks with pointers. A stack is passed
+// to functions that are not inlined, which would keep the whole builder in
+// memory instead of registers.
+template<typename xBuilder, typename xNext>
+ASTERIA_ALWAYS_INLINE
+uint32_t
+do_drive_tokens(xBuilder& b, Parser_Context& ctx, const Parser_Token& token, uint32_t state,
+                Options opts, xNext&& next)
+  {
+    switch(state)
+      {
+      case state_value:
+      do_value_:
+        if(!(opts & option_bypass_nesting_limit) && (b.depth() > 32)) {
+          do_err(ctx, "Nesting limit exceeded");
+          return state_error;
+        }
+
+        if(!b.do_value())
+          goto do_value_done_;
+
+        if(token[0] == '[') {
+          b.do_start(false);
+          if(!next())
+            return state_array_open;
+
+          goto do_array_open_;
+        }
+        else if(token[0] == '{') {
+          b.do_start(true);
+          if(!next())
+            return state_object_open;
+
+          goto do_object_open_;
+        }
+
+        b.do_scalar();
+        goto do_value_done_;
+
+      case state_array_open:
+      do_array_open_:
+        if(token[0] == ']') {
+          // empty
+          b.do_empty(false);
+          goto do_value_done_;
+        }
+
+        // open
+        b.do_push(false);
+        goto do_element_;
+
+      case state_object_open:
+      do_object_open_:
+        if(token[0] == '}') {
+          // empty
+          b.do_empty(true);
+          goto do_value_done_;
+        }
+
+        // open
+        b.do_push(true);
+        goto do_member_;
+
+      case state_colon:
+      do_colon_:
+        if(token[0] != ':') {
+          do_err(ctx, "Missing colon");
+          return state_error;
+        }
+
+        if(!next())
+          return state_value;
+
+        goto do_value_;
+
+      case state_next:
+      do_next_:
+        if(b.in_array()) {
+          // array
+          if(token[0] == ']')
+            goto do_close_;
+
+          if(token[0] != ',') {
+            do_err(ctx, "Missing comma or closed bracket");
+            return state_error;
+          }
+
+          if(!next())
+            return state_array_comma;
+
+          goto do_array_comma_;
+        }
+        else {
+          // object
+          if(token[0] == '}')
+            goto do_close_;
+
+          if(token[0] != ',') {
+            do_err(ctx, "Missing comma or closed brace");
+            return state_error;
+          }
+
+          if(!next())
+            return state_object_comma;
+
+          goto do_object_comma_;
+        }
+
+      case state_array_comma:
+      do_array_comma_:
+        if((token[0] == ']') && (opts & option_allow_trailing_commas))
+          goto do_close_;
+
+      do_element_:
+        if(!b.do_element())
+          goto do_value_done_;
+
+        goto do_value_;
+
+      case state_object_comma:
+      do_object_comma_:
+        if((token[0] == '}') && (opts & option_allow_trailing_commas))
+          goto do_close_;
+
+      do_member_:
+        // We are inside an object, so this token must be a key string, followed
+        // by a colon, followed by its value.
+        if(token[0] != '\"') {
+          do_err(ctx, "Missing key string");
+          return state_error;
+        }
+
+        if(!b.do_member())
+          goto do_value_done_;
+
+        if(ctx.error)
+          return state_error;
+
+        if(!next())
+          return state_colon;
+
+        goto do_colon_;
+
+      do_close_:
+        b.do_pop();
+
+      do_value_done_:
+        if(ctx.error)
+          return state_error;
+
+        if(b.at_top())
+          return state_done;
+
+        if(!next())
+          return state_next;
+
+        goto do_next_;
+      }
+
+    // The value has been completed, or an error has occurred.
+    return state;
+  }
+
+// Reports an error for the end of input in `state`.
+template<typename xBuilder>
+ASTERIA_ALWAYS_INLINE
+void
+do_drive_end(const xBuilder& b, Parser_Context& ctx, uint32_t state)
+  {
+    switch(state)
+      {
+      case state_value:
+        if(b.at_top())
+          return do_err(ctx, "Blank input");
+        else
+          return do_err(ctx, "Missing value");
+
+      case state_array_open:
+        return do_err(ctx, "Array not terminated properly");
+
+      case state_object_open:
+        return do_err(ctx, "Object not terminated properly");
+
+      case state_colon:
+        return do_err(ctx, "Missing colon");
+
+      case state_next:
+        if(b.in_array())
+          return do_err(ctx, "Array not terminated properly");
+        else
+          return do_err(ctx, "Object not terminated properly");
+
+      case state_array_comma:
+        return do_err(ctx, "Missing value");
+
+      case state_object_comma:
+        return do_err(ctx, "Missing key string");
+      }
+  }
+
+// Parses a value, whose first token has been stored into `token`, with tokens
+// from `usrc`. If the value is a number or identifier, the character after it is
+// left in `ctx.c`.
+template<typename xBuilder, typename xSource>
+void
+do_drive_value(xBuilder& b, Parser_Context& ctx, xSource& usrc, Parser_Token& token,
+               Options opts)
+  {
+    auto next = [&] {
+      do_token(token, ctx, usrc);
+      return !ctx.error && !token.empty();
+    };
+
+    uint32_t state = do_drive_tokens(b, ctx, token, state_value, opts, next);
+
+    // If the input has ended before the value, report an error for `state`.
+    if((state < state_done) && !ctx.error)
+      do_drive_end(b, ctx, state);
+  }
+
+// This builds a tree of values. Objects at the same level of nesting are assumed
+// to have the same keys, so they are interned and reserved in advance.
+template<typename xSource>
+struct Value_Builder
+  {
+    Parser_Context* ctx;
+    xSource* usrc;
+    Parser_Workspace* work;
+    Options opts;
+    Value* pstor;
+    size_t count = 0;  // elements or members of the array or object to open
+
+    size_t
+    depth()
+      const noexcept
+      {
+        return this->work->depth + this->work->stack.size();
+      }
+
+    bool
+    at_top()
+      const noexcept
+      {
+        return this->work->stack.empty();
+      }
+
+    bool
+    in_array()
+      const noexcept
+      {
+        return this->work->stack.back().psa;
+      }
+
+    bool
+    do_value()
+      noexcept
+      {
+        return true;
+      }
+
+    void
+    do_start(bool /*object*/)
+      {
+        this->count = do_next_count(*(this->usrc));
+      }
+
+    void
+    do_empty(bool object)
+      {
+        if(object)
+          this->pstor->open_object();
+        else
+          this->pstor->open_array();
+      }
+
+    void
+    do_push(bool object)
+      {
+        auto& stack = this->work->stack;
+        auto& frm = stack.emplace_back();
+        frm.target = this->pstor;
+
+        if(!object) {
+          frm.psa = &(this->pstor->open_array());
+          if(this->count != 0)
+            frm.psa->reserve(this->count);
+          return;
+        }
+
+        frm.pso = &(this->pstor->open_object());
+
+        // Make room for all members if they have been counted, or for keys of the
+        // previous object at this level.
+        auto& shapes = this->work->shapes;
+        if(shapes.size() < stack.size())
+          shapes.resize(stack.size());
+
+        const auto& shape = shapes[stack.size() - 1];
+        if(this->count == 0)
+          this->count = shape.size();
+        if(this->count != 0)
+          frm.pso->reserve(this->count);
+      }
+
+    bool
+    do_element()
+      {
+        this->pstor = &(this->work->stack.back().psa->emplace_back());
+        return true;
+      }
+
+    bool
+    do_member()
+      {
+        const auto& token = this->work->token;
+        auto& shape = this->work->shapes[this->work->stack.size() - 1];
+        auto pso = this->work->stack.back().pso;
+        auto emr = pso->try_emplace(do_shape_key(shape, pso->size(), this->work->key_pool,
+                                                 this->work->dict, token.data() + 1, token.size() - 1));
+        if(!emr.second) {
+          do_err(*(this->ctx), "Duplicate key string");
+          return false;
+        }
+
+        this->pstor = &(emr.first->second);
+        return true;
+      }
+
+    void
+    do_scalar()
+      {
+        do_parse_scalar(*(this->pstor), *(this->ctx), this->work->token, this->work->numg, this->opts);
+      }
+
+    void
+    do_pop()
+      {
+        auto& stack = this->work->stack;
+        const auto& frm = stack.back();
+        if(frm.pso) {
+          // Keep keys of this object for the next one.
+          auto& shape = this->work->shapes[stack.size() - 1];
+          if(shape.size() > frm.pso->size())
+            shape.erase(shape.begin() + static_cast<ptrdiff_t>(frm.pso->size()), shape.end());
+        }
+
+        this->pstor = frm.target;
+        stack.pop_back();
+      }
+  };
+
+// Parses a value, whose first token has been stored into `work.token`. If the
+// value is a number or identifier, the character after it is left in `ctx.c`.
+template<typename xSource>
+void
+do_parse_value(Value& root, Parser_Context& ctx, xSource& usrc, Parser_Workspace& work,
+               Options opts)
+  {
+    Value_Builder<xSource> b = { &ctx, &usrc, &work, opts, &root };
+    do_drive_value(b, ctx, usrc, work.token, opts);
+  }
+
+// Drops interned keys from time to time, so unique keys of many values do not
+// pile up. Shapes are dropped too, as they refer to the same strings.
+void
+do_trim_keys(Parser_Workspace& work)
+  {
+    if(work.key_pool.size() <= 4096)
+      return;
+
+    work.key_pool.clear();
+    work.shapes.clear();
+  }
+
+// Parses a value, with buffers from `work`, which may be reused for multiple
+// sources.
+template<typename xSource>
+void
+do_parse_with(Value& root, Parser_Context& ctx, xSource& usrc, Parser_Workspace& work,
+              Options opts)
+  {
+    // Initialize parser state.
+    root.clear();
+    ::std::memset(&ctx, 0, sizeof(ctx));
+    ctx.c = -1;
+
+    work.stack.clear();
+    work.depth = 0;
+    do_prepare_source(usrc, work);
+
+    do_trim_keys(work);
+
+    // Make room for keys in proportion to the input.
+    if constexpr(is_memory_source<xSource>)
+      work.key_pool.reserve(::std::min<size_t>(static_cast<size_t>(usrc.eptr - usrc.bptr) / 64, 1024));
+
+    do_token(work.token, ctx, usrc);
+    if(ctx.error)
+      return;
+
+    if(work.token.empty())
+      return do_err(ctx, "Blank input");
+
+    do_parse_value(root, ctx, usrc, work, opts);
+  }
+
+template<typename xSource>
+void
+do_parse_with(Value& root, Parser_Context& ctx, xSource& usrc, Options opts)
+  {
+    Parser_Workspace work;
+    do_parse_with(root, ctx, usrc, work, opts);
+  }
+
+// This passes events to a handler instead of building a tree. Duplicate keys are
+// diagnosed by the handler, which may set an error in `on_key()`.
+template<typename xHandler>
+struct Event_Builder
+  {
+    Parser_Context* ctx;
+    xHandler* handler;
+    Parser_Workspace* work;
+    Options opts;
+    V_binary* bin;
+    ::std::vector<bool>* stack;  // `true` for an array and `false` for an object
+
+    size_t
+    depth()
+      const noexcept
+      {
+        return this->stack->size();
+      }
+
+    bool
+    at_top()
+      const noexcept
+      {
+        return this->stack->empty();
+      }
+
+    bool
+    in_array()
+      const noexcept
+      {
+        return this->stack->back();
+      }
+
+    bool
+    do_value()
+      noexcept
+      {
+        return true;
+      }
+
+    void
+    do_start(bool object)
+      {
+        if(object)
+          this->handler->on_start_object();
+        else
+          this->handler->on_start_array();
+      }
+
+    void
+    do_empty(bool object)
+      {
+        if(object)
+          this->handler->on_end_object();
+        else
+          this->handler->on_end_array();
+      }
+
+    void
+    do_push(bool object)
+      {
+        this->stack->push_back(!object);
+      }
+
+    bool
+    do_element()
+      noexcept
+      {
+        return true;
+      }
+
+    bool
+    do_member()
+      {
+        const auto& token = this->work->token;
+        this->handler->on_key(token.data() + 1, token.size() - 1);
+        return true;
+      }
+
+    void
+    do_scalar()
+      {
+        do_emit_scalar(*(this->handler), *(this->ctx), this->work->token, this->work->numg, *(this->bin),
+                       this->opts);
+      }
+
+    void
+    do_pop()
+      {
+        this->do_empty(!this->stack->back());
+        this->stack->pop_back();
+      }
+  };
+
+// Parses a value, and passes events to `handler` instead of building a tree.
+template<typename xHandler, typename xSource>
+void
+do_parse_events(Parser_Context& ctx, xHandler& handler, xSource& usrc, Options opts)
+  {
+    // Initialize parser state.
+    ::std::memset(&ctx, 0, sizeof(ctx));
+    ctx.c = -1;
+
+    Parser_Workspace work;
+    do_prepare_source(usrc, work);
+
+    do_token(work.token, ctx, usrc);
+    if(ctx.error)
+      return;
+
+    if(work.token.empty())
+      return do_err(ctx, "Blank input");
+
+    // Break deep recursion with a handwritten stack.
+    V_binary bin;
+    ::std::vector<bool> stack;
+    Event_Builder<xHandler> b = { &ctx, &handler, &work, opts, &bin, &stack };
+    do_drive_value(b, ctx, usrc, work.token, opts);
+  }
+
+// This handler checks a value without building it. Keys of all open objects are
+// copied into `text`, and duplicate keys are diagnosed as `do_parse_value()`
+// does. Small objects are searched linearly; large ones are indexed by hash
+// tables, which are reused for objects at the same level of nesting.
+struct Validating_Handler final
+  : Event_Handler
+  {
+    struct xKey
+      {
+        size_t hash;
+        size_t offset;
+        size_t length;
+      };
+
+    struct xFrame
+      {
+        size_t kbegin;
+        size_t tbegin;
+        bool hashed;
+      };
+
+    Parser_Context* ctx;
+    ::std::vector<char> text;
+    ::std::vector<xKey> keys;
+    ::std::vector<xFrame> frames;
+    ::std::vector<::std::vector<uint32_t>> tables;
+
+    explicit
+    Validating_Handler(Parser_Context& c)
+      : ctx(&c)  { }
+
+    void
+    on_start_object()
+      override
+      {
+        auto& frm = this->frames.emplace_back();
+        frm.kbegin = this->keys.size();
+        frm.tbegin = this->text.size();
+        frm.hashed = false;
+
+        if(this->tables.size() < this->frames.size())
+          this->tables.emplace_back();
+      }
+
+    void
+    on_end_object()
+      override
+      {
+        const auto& frm = this->frames.back();
+        this->keys.resize(frm.kbegin);
+        this->text.resize(frm.tbegin);
+        this->frames.pop_back();
+      }
+
+    void
+    do_rehash(size_t nslots)
+      {
+        const auto& frm = this->frames.back();
+        auto& table = this->tables[this->frames.size() - 1];
+        table.assign(nslots, 0);
+
+        for(size_t k = frm.kbegin;  k != this->keys.size();  ++k) {
+          size_t i = this->keys[k].hash & (nslots - 1);
+          while(table[i] != 0)
+            i = (i + 1) & (nslots - 1);
+          table[i] = static_cast<uint32_t>(k + 1);
+        }
+      }
+
+    void
+    on_key(const char* str, size_t len)
+      override
+      {
+        auto& frm = this->frames.back();
+        size_t hval = ::asteria::phcow_string::hasher()(str, len);
+
+        auto is_same = [&](size_t k) {
+          const auto& key = this->keys[k];
+          return (key.hash == hval) && (key.length == len)
+                 && ::asteria::xmemeq(this->text.data() + key.offset, str, len);
+        };
+
+        if(!frm.hashed) {
+          for(size_t k = frm.kbegin;  k != this->keys.size();  ++k)
+            if(is_same(k))
+              return do_err(*(this->ctx), "Duplicate key string");
+        }
+        else {
+          const auto& table = this->tables[this->frames.size() - 1];
+          size_t i = hval & (table.size() - 1);
+          while(table[i] != 0) {
+            if(is_same(table[i] - 1))
+              return do_err(*(this->ctx), "Duplicate key string");
+            i = (i + 1) & (table.size() - 1);
+          }
+        }
+
+        auto& key = this->keys.emplace_back();
+        key.hash = hval;
+        key.offset = this->text.size();
+        key.length = len;
+        this->text.insert(this->text.end(), str, str + len);
+
+        // Keep tables at most half full.
+        size_t count = this->keys.size() - frm.kbegin;
+        if(count <= 16)
+          return;
+
+        auto& table = this->tables[this->frames.size() - 1];
+        if(!frm.hashed || (count * 2 > table.size())) {
+          frm.hashed = true;
+          this->do_rehash(size_t(1) << (66 - ::asteria::lzcnt64(count)));
+        }
+        else {
+          size_t i = hval & (table.size() - 1);
+          while(table[i] != 0)
+            i = (i + 1) & (table.size() - 1);
+          table[i] = static_cast<uint32_t>(this->keys.size());
+        }
+      }
+  };
+
+// Parses values until the end of input. Values may be separated by whitespace,
+// such as TAXON lines. Each value is passed to `callback` once it has been
+// completed.
+template<typename xSource>
+void
+do_parse_stream(Parser_Context& ctx, const Callback_Ref& callback, xSource& usrc,
+                Options opts)
+  {
+    // Initialize parser state.
+    ::std::memset(&ctx, 0, sizeof(ctx));
+    ctx.c = -1;
+
+    Parser_Workspace work;
+    do_prepare_source(usrc, work);
+    Value value;
+
+    for(;;) {
+      do_token(work.token, ctx, usrc);
+      if(ctx.error || work.token.empty())
+        return;
+
+      value.clear();
+      do_trim_keys(work);
+      do_parse_value(value, ctx, usrc, work, opts);
+      if(ctx.error)
+        return;
+
+      callback.fn_call(callback.obj, value);
+    }
+  }
+
+// Finds commas that split the top-level array in `[bptr,eptr)` into at most
+// `nchunks` chunks of roughly equal sizes, and stores them into `splits`. If the
+// input does not start with an array, or the array is not terminated, `splits`
+// is left empty.
+void
+do_split_array(::std::vector<const char*>& splits, const char* bptr, const char* eptr,
+               size_t nchunks)
+  {
+    splits.clear();
+    const size_t step = static_cast<size_t>(eptr - bptr) / nchunks;
+    size_t next = step;
+    size_t depth = 0;
+    bool started = false;
+    bool closed = false;
+
+    do_scan_blocks(bptr, eptr,
+      [&](size_t base, uint64_t ops, uint64_t others)
+        {
+          if(!started) {
+            // The first token must be an open bracket.
+            uint64_t first = (ops | others) & (0 - (ops | others));
+            if(first == 0)
+              return true;
+            else if(!(ops & first) || (bptr[base + ::asteria::tzcnt64(first)] != '['))
+              return false;
+            started = true;
+          }
+
+          while(ops != 0) {
+            size_t off = base + ::asteria::tzcnt64(ops);
+            ops &= ops - 1;
+
+            if(is_any(bptr[off], '[', '{'))
+              depth ++;
+            else if(is_any(bptr[off], ']', '}')) {
+              if(-- depth == 0) {
+                closed = true;
+                return false;
+              }
+            }
+            else if((bptr[off] == ',') && (depth == 1) && (off >= next)) {
+              splits.push_back(bptr + off);
+              next = off + step;
+            }
+          }
+          return true;
+        });
+
+    if(!closed)
+      splits.clear();
+  }
+
+// Parses elements of the top-level array from a chunk. The first chunk starts
+// with the open bracket, and all the others start after a comma. All chunks but
+// the last one end before a comma.
+void
+do_parse_chunk(V_array& values, Parser_Context& ctx, Chunk_Source& csrc, bool first, bool last,
+               Options opts)
+  {
+    // Initialize parser state.
+    ::std::memset(&ctx, 0, sizeof(ctx));
+    ctx.c = -1;
+
+    Parser_Workspace work;
+    do_prepare_source(csrc, work);
+    work.depth = 1;
+    auto& token = work.token;
+
+    do_token(token, ctx, csrc);
+    if(first) {
+      if(ctx.error)
+        return;
+
+      // The top-level array is joined by the caller, so drop its count.
+      ASTERIA_ASSERT(token[0] == '[');
+      do_next_count(csrc);
+      do_token(token, ctx, csrc);
+      if(ctx.eof)
+        return do_err(ctx, "Array not terminated properly");
+    }
+    else if(ctx.eof)
+      return do_err(ctx, "Missing value");
+
+    if(ctx.error)
+      return;
+
+    if((token[0] == ']') && (first || (opts & option_allow_trailing_commas)))
+      return;
+
+    for(;;) {
+      do_parse_value(values.emplace_back(), ctx, csrc, work, opts);
+      if(ctx.error)
+        return;
+
+      do_token(token, ctx, csrc);
+      if(ctx.eof) {
+        if(last)
+          do_err(ctx, "Array not terminated properly");
+        return;
+      }
+      else if(ctx.error)
+        return;
+
+      if(token[0] == ']')
+        return;
+
+      if(token[0] != ',')
+        return do_err(ctx, "Missing comma or closed bracket");
+
+      do_token(token, ctx, csrc);
+      if(ctx.eof)
+        return do_err(ctx, "Missing value");
+      else if(ctx.error)
+        return;
+
+      if((token[0] == ']') && (opts & option_allow_trailing_commas))
+        return;
+    }
+  }
+
+template<typename xSink>
+ASTERIA_FLATTEN
+void
+do_escape_string_utf16(const xSink& usink, const ::asteria::cow_string& str)
+  {
+    auto bptr = str.data();
+    const auto eptr = str.data() + str.size();
+    for(;;) {
+      // Get a sequence of characters that require no escaping.
+      auto tptr = bptr;
+      while(eptr != tptr) {
+        if(is_any(*tptr, '\\', '\"', '/') || !is_within(*tptr, 0x20, 0x7E))
+          goto break_found_;
+        ++ tptr;
+
+#ifdef TAXON_HAS_SIMD
+        while(eptr - tptr >= static_cast<ptrdiff_t>(sizeof(simd_word_type))) {
+          simd_word_type t = simd_load(tptr);
+          simd_mask_type mask = simd_movmask(simd_cmpeq(t, simd_bcast('\\')))
+                                | simd_movmask(simd_cmpeq(t, simd_bcast('\"')))
+                                | simd_movmask(simd_cmpeq(t, simd_bcast('/')))
+                                | simd_movmask(simd_cmpgt(simd_bcast(0x20), t))
+                                | simd_movmask(simd_cmpgt(t, simd_bcast(0x7E)));
+          tptr += simd_tzcnt(mask);
+          if(mask != 0)
+            goto break_found_;
+        }
+#endif
+      }
+
+  break_found_:
+      if(tptr != bptr)
+        usink.putn(bptr, static_cast<size_t>(tptr - bptr));
+      bptr = tptr;
+
+      if(bptr == eptr)
+        break;
+
+      int next = static_cast<uint8_t>(*(bptr ++));
+      switch(next)
+        {
+        case '\\':
+        case '\"':
+        case '/':
+          {
+            char temp[2] = { '\\', static_cast<char>(next) };
+            usink.putn(temp, 2);
+          }
+          break;
+
+        case '\b':
+          usink.putn("\\b", 2);
+          break;
+
+        case '\f':
+          usink.putn("\\f", 2);
+          break;
+
+        case '\n':
+          usink.putn("\\n", 2);
+          break;
+
+        case '\r':
+          usink.putn("\\r", 2);
+          break;
+
+        case '\t':
+          usink.putn("\\t", 2);
+          break;
+
+        default:
+          if(is_within(next, 0x20, 0x7E))
+            usink.putc(static_cast<char>(next));
+          else {
+            // Read a multibyte character.
+            char16_t c16;
+            ::std::mbstate_t mbst = { };
+            size_t mblen = ::std::mbrtoc16(&c16, tptr, static_cast<size_t>(eptr - tptr), &mbst);
+            if(static_cast<int>(mblen) < 0) {
+              // The input string is invalid. Consume one byte anyway, but print
+              // a replacement character.
+              usink.putn("\\uFFFD", 6);
+            }
+            else if(mblen == 0) {
+              // A null byte has been consumed and stored into `c16`.
+              usink.putn("\\u0000", 6);
+            }
+            else {
+              // `mblen` bytes have been consumed, converted and stored into `c16`.
+              char temp[16] = "\\u1234\\u5678zzz";
+              uint32_t tlen = 6;
+              for(uint32_t k = 2;  k != 6;  ++k) {
+                int c = c16 >> 12;
+                c16 = static_cast<uint16_t>(c16 << 4);
+                if(c < 10)
+                  temp[k] = static_cast<char>(c + '0');
+                else
+                  temp[k] = static_cast<char>(c - 10 + 'A');
+              }
+
+              if(static_cast<int>(::std::mbrtoc16(&c16, nullptr, 0, &mbst)) == -3) {
+                // No input has been consumed, but a trailing surrogate has been
+                // stored into `c16`.
+                tlen = 12;
+                for(uint32_t k = 8;  k != 12;  ++k) {
+                  int c = c16 >> 12;
+                  c16 = static_cast<uint16_t>(c16 << 4);
+                  if(c < 10)
+                    temp[k] = static_cast<char>(c + '0');
+                  else
+                    temp[k] = static_cast<char>(c - 10 + 'A');
+                }
+              }
+
+              usink.putn(temp, tlen);
+              bptr = tptr + mblen;
+            }
+          }
+        }
+    }
+  }
+
+template<typename xSink>
+void
+do_print_to(const xSink& usink, const Value& root, Options opts)
+  {
+    // Break deep recursion with a handwritten stack.
+    struct xFrame
+      {
+        const V_array* psa;
+        V_array::const_iterator ita;
+        const V_object* pso;
+        V_object::const_iterator ito;
+      };
+
+    ::std::vector<xFrame> stack;
+    ::asteria::ascii_numput nump;
+    const Value* pstor = &root;
+
+  do_unpack_loop_:
+    switch(pstor->type())
+      {
+      case t_null:
+        usink.putn("null", 4);
+        break;
+
+      case t_array:
+        if(!pstor->as_array().empty()) {
+          // open
+          auto& frm = stack.emplace_back();
+          frm.psa = &(pstor->as_array());
+          frm.ita = frm.psa->begin();
+          usink.putc('[');
+          pstor = &*(frm.ita);
+          goto do_unpack_loop_;
+        }
+
+        usink.putn("[]", 2);
+        break;
+
+      case t_object:
+        if(!pstor->as_object().empty()) {
+          // open
+          auto& frm = stack.emplace_back();
+          frm.pso = &(pstor->as_object());
+          frm.ito = frm.pso->begin();
+          usink.putn("{\"", 2);
+          do_escape_string_utf16(usink, frm.ito->first.rdstr());
+          usink.putn("\":", 2);
+          pstor = &(frm.ito->second);
+          goto do_unpack_loop_;
+        }
+
+        usink.putn("{}", 2);
+        break;
+
+      case t_boolean:
+        nump.put_TB(pstor->as_boolean());
+        usink.putn(nump.data(), nump.size());
+        break;
+
+      case t_integer:
+        if(opts & option_json_mode) {
+          // as floating-point number; inaccurate for large values
+          nump.put_DD(static_cast<V_number>(pstor->as_integer()));
+          usink.putn(nump.data(), nump.size());
+        }
+        else {
+          // precise; annotated
+          nump.put_DI(pstor->as_integer());
+          usink.putn("\"$l:", 4);
+          usink.putn(nump.data(), nump.size());
+          usink.putc('\"');
+        }
+        break;
+
+      case t_number:
+        if(::std::isfinite(pstor->as_number())) {
+          // finite; unquoted
+          nump.put_DD(pstor->as_number());
+          usink.putn(nump.data(), nump.size());
+        }
+        else if(opts & option_json_mode) {
+          // invalid; nullified
+          usink.putn("null", 4);
+        }
+        else {
+          // non-finite; annotated
+          usink.putn("\"$d:", 4);
+          nump.put_DD(pstor->as_number());
+          usink.putn(nump.data(), nump.size());
+          usink.putc('\"');
+        }
+        break;
+
+      case t_string:
+        if((opts & option_json_mode) || (pstor->as_string()[0] != '$')) {
+          // general; quoted
+          usink.putc('\"');
+          do_escape_string_utf16(usink, pstor->as_string());
+          usink.putc('\"');
+        }
+        else {
+          // starts with `$`; annotated
+          usink.putn("\"$s:", 4);
+          do_escape_string_utf16(usink, pstor->as_string());
+          usink.putc('\"');
+        }
+        break;
+
+      case t_binary:
+        if(opts & option_json_mode) {
+          // invalid; nullified
+          usink.putn("null", 4);
+        }
+        else {
+          // annotated
+          auto bptr = pstor->as_binary().data();
+          const auto eptr = bptr + pstor->as_binary().size();
+
+          bool use_hex = true;
+          if(opts & option_bin_as_base64)
+            use_hex = false;
+          else
+            use_hex = (pstor->as_binary().size() <= 4)  // small
+                      || ((pstor->as_binary().size() % 4 == 0)
+                          && (pstor->as_binary().size() / 4 <= 8));
+
+          if(use_hex) {
+            // hex
+            usink.putn("\"$h:", 4);
+
+            const auto hex_digit = [](uint64_t b)
+              {
+                if(b < 10)
+                  return static_cast<char>('0' + b);
+                else
+                  return static_cast<char>('a' + b - 10);
+              };
+
+            while(bptr != eptr) {
+              // Encode a block into `hex_block`, then flush it. Each block
+              // contains a multiple of SIMD words, except the last one.
+              char hex_block[1024];
+              char* tptr = hex_block;
+              const auto bend = bptr + ::std::min<ptrdiff_t>(eptr - bptr, 512);
+
+#ifdef TAXON_HAS_SIMD
+              while(bend - bptr >= static_cast<ptrdiff_t>(sizeof(simd_word_type) / 2)) {
+                simd_encode_hex(tptr, bptr);
+                tptr += sizeof(simd_word_type);
+                bptr += sizeof(simd_word_type) / 2;
+              }
+#endif
+
+              while(bptr != bend) {
+                tptr[0] = hex_digit(*bptr >> 4U & 15U);
+                tptr[1] = hex_digit(*bptr & 15U);
+                tptr += 2;
+                bptr ++;
+              }
+
+              usink.putn(hex_block, static_cast<size_t>(tptr - hex_block));
+            }
+          }
+          else {
+            // base64
+            usink.putn("\"$b:", 4);
+
+            const auto base64_digit = [](uint32_t b)
+              {
+                if(b < 26)
+                  return static_cast<char>('A' + b);
+                else if(b < 52)
+                  return static_cast<char>('a' + b - 26);
+                else if(b < 62)
+                  return static_cast<char>('0' + b - 52);
+                else if(b < 63)
+                  return '+';
+                else
+                  return '/';
+              };
+
+            while(bptr != eptr) {
+              // Encode a block into `b64_block`, then flush it. Each block
+              // contains a multiple of SIMD words, except the last one.
+              char b64_block[1024];
+              char* tptr = b64_block;
+              const auto bend = bptr + ::std::min<ptrdiff_t>(eptr - bptr, 768);
+
+#ifdef TAXON_HAS_SIMD
+              while(bend - bptr >= static_cast<ptrdiff_t>(sizeof(simd_word_type) / 4 * 3)) {
+                simd_encode_base64(tptr, bptr);  // use the null terminator!
+                tptr += sizeof(simd_word_type);
+                bptr += sizeof(simd_word_type) / 4 * 3;
+              }
+#endif
+
+              while(bend - bptr >= 3) {
+                // 3-byte group
+                uint32_t word = ::asteria::load_be<uint32_t>(bptr);  // use the null terminator!
+                bptr += 3;
+
+                for(uint32_t t = 0;  t != 4;  ++t) {
+                  tptr[t] = base64_digit(word >> 26);
+                  word <<= 6;
+                }
+
+                tptr += 4;
+              }
+
+              if(bptr != bend) {
+                // 1-byte or 2-byte group
+                size_t nrem = static_cast<size_t>(bend - bptr);
+                uint32_t word = ::asteria::load_be<uint16_t>(bptr);  // use the null terminator!
+                bptr += nrem;
+
+                for(uint32_t t = 0;  t != nrem + 1;  ++t) {
+                  tptr[t] = base64_digit(word >> 10 & 0x3F);
+                  word <<= 6;
+                }
+
+                for(uint32_t t = static_cast<uint32_t>(nrem) + 1;  t != 4;  ++t)
+                  tptr[t] = '=';
+
+                tptr += 4;
+              }
+
+              usink.putn(b64_block, static_cast<size_t>(tptr - b64_block));
+            }
+          }
+          usink.putc('\"');
+        }
+        break;
+
+      case t_time:
+        if(opts & option_json_mode) {
+          // invalid; nullified
+          usink.putn("null", 4);
+        }
+        else {
+          // annotated
+          nump.put_DI(::std::chrono::time_point_cast<::std::chrono::milliseconds>(
+                                pstor->as_time()).time_since_epoch().count());
+          usink.putn("\"$t:", 4);
+          usink.putn(nump.data(), nump.size());
+          usink.putc('\"');
+        }
+        break;
+
+      default:
+        ::asteria::sprintf_and_throw<::std::invalid_argument>(
+              "taxon::Value: unknown type enumeration `%d`", pstor->type());
+      }
+
+    while(!stack.empty()) {
+      auto& frm = stack.back();
+      if(frm.psa) {
+        // array
+        if(++ frm.ita != frm.psa->end()) {
+          // next
+          usink.putc(',');
+          pstor = &*(frm.ita);
+          goto do_unpack_loop_;
+        }
+
+        // end
+        usink.putc(']');
+      }
+      else {
+        // object
+        if(++ frm.ito != frm.pso->end()) {
+          // next
+          usink.putn(",\"", 2);
+          do_escape_string_utf16(usink, frm.ito->first.rdstr());
+          usink.putn("\":", 2);
+          pstor = &(frm.ito->second);
+          goto do_unpack_loop_;
+        }
+
+        // end
+        usink.putc('}');
+      }
+
+      // close
+      stack.pop_back();
+    }
+  }
+
+void
+do_parse_file(Value& root, Parser_Context& ctx, ::std::FILE* fp, Options opts)
+  {
+    if(::ftello(fp) >= 0) {
+      // The file is seekable, so it can be read in blocks; unconsumed bytes will
+      // be returned.
+      Buffered_Source bsrc(fp);
+      do_parse_with(root, ctx, bsrc, opts);
+    }
+    else {
+      File_Source fsrc(fp);
+      do_parse_with(root, ctx, fsrc, opts);
+    }
+  }
+
+void
+do_parse_mapped_file(Value& root, Parser_Context& ctx, const char* path, Options opts)
+  {
+    struct xMapping
+      {
+        int fd = -1;
+        void* ptr = MAP_FAILED;
+        size_t size = 0;
+
+        ~xMapping()
+          {
+            if(this->ptr != MAP_FAILED)
+              ::munmap(this->ptr, this->size);
+            if(this->fd >= 0)
+              ::close(this->fd);
+          }
+      };
+
+    xMapping map;
+    map.fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if(map.fd < 0) {
+      root.clear();
+      ::std::memset(&ctx, 0, sizeof(ctx));
+      return do_err(ctx, "Could not open file");
+    }
+
+    struct ::stat st;
+    if((::fstat(map.fd, &st) == 0) && S_ISREG(st.st_mode) && (st.st_size > 0)
+       && (static_cast<uint64_t>(st.st_size) <= SIZE_MAX)) {
+      // Map the file and parse it as a whole. The structural index is built in
+      // windows, so no memory is allocated in proportion to the file. Huge pages
+      // are not available on all filesystems, so errors from `madvise()` are
+      // ignored.
+      map.size = static_cast<size_t>(st.st_size);
+      map.ptr = ::mmap(nullptr, map.size, PROT_READ, MAP_PRIVATE, map.fd, 0);
+      if(map.ptr != MAP_FAILED) {
+        ::madvise(map.ptr, map.size, MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+        ::madvise(map.ptr, map.size, MADV_HUGEPAGE);
+#endif
+        Memory_Source msrc(static_cast<const char*>(map.ptr), map.size);
+        return do_parse_with(root, ctx, msrc, opts);
+      }
+    }
+
+    // The file can't be mapped, which happens with pipes and devices, so read
+    // it in blocks.
+    Buffered_Source bsrc(map.fd);
+    do_parse_with(root, ctx, bsrc, opts);
+  }
+
+// Gets the offset past the last byte of the current token. If a number or an
+// identifier has been parsed, the character after it has been consumed.
+ASTERIA_ALWAYS_INLINE
+int64_t
+do_token_end(const Parser_Context& ctx, const Memory_Source& msrc)
+  {
+    int64_t off = msrc.tell();
+    if(ctx.c >= 0)
+      off -= 1 + (ctx.c > 0x7F) + (ctx.c > 0x7FF) + (ctx.c > 0xFFFF);
+    return off;
+  }
+
+// Gets the type of a scalar token without decoding it. Payloads of annotated
+// strings are not validated.
+Type
+do_classify_scalar(Parser_Context& ctx, const Parser_Token& token, Options opts)
+  {
+    if(is_any(token[0], '+', '-') || is_within(token[0], '0', '9'))
+      return t_number;
+    else if(token[0] == '\"') {
+      if((opts & option_json_mode) || (token[1] != '$'))
+        return t_string;
+      else if(token[3] == ':')
+        switch(token[2])
+          {
+          case 'l':
+            return t_integer;
+
+          case 'd':
+            return t_number;
+
+          case 's':
+            return t_string;
+
+          case 't':
+            return t_time;
+
+          case 'h':
+          case 'b':
+            return t_binary;
+          }
+
+      do_err(ctx, "Unknown type annotator");
+      return t_null;
+    }
+    else if(token.equals("null", 4))
+      return t_null;
+    else if(token.equals("true", 4) || token.equals("false", 5))
+      return t_boolean;
+
+    do_err(ctx, "Invalid token");
+    return t_null;
+  }
+
+// Decodes a key string from its source text, which has been validated.
+void
+do_decode_key(Parser_Token& token, const char* str, size_t len)
+  {
+    Parser_Context ctx;
+    ::std::memset(&ctx, 0, sizeof(ctx));
+    ctx.c = -1;
+
+    Memory_Source msrc(str, len);
+    do_token(token, ctx, msrc);
+    ASTERIA_ASSERT(!ctx.error && (token[0] == '\"'));
+  }
+
+// This is a document of a batch. Offsets are relative to the beginning of the
+// batch, which is the beginning of the whole buffer of TAXON lines, or zero.
+struct Batch_Document
+  {
+    const char* bptr;
+    size_t len;
+    int64_t boff;
+  };
+
+// Parses independent documents with multiple threads. Each thread takes a few
+// documents at a time, until there are none left, and reuses its own workspace
+// for all of them.
+bool
+do_parse_batch(V_array& values, ::std::vector<Parser_Context>& contexts,
+               const ::std::vector<Batch_Document>& docs, unsigned nthreads, Options opts,
+               Key_Dictionary* dict)
+  {
+    if(dict && !dict->thread_safe() && (nthreads != 1))
+      ::asteria::sprintf_and_throw<::std::invalid_argument>(
+            "taxon::parse_batch: key dictionary is not thread-safe");
+
+    values.clear();
+    values.reserve(docs.size());
+    for(size_t k = 0;  k != docs.size();  ++k)
+      values.emplace_back();
+
+    contexts.resize(docs.size());
+    if(docs.empty())
+      return true;
+
+    if(nthreads == 0)
+      nthreads = ::std::max(::std::thread::hardware_concurrency(), 1U);
+
+    // Take small documents in groups, so threads don't contend on the counter.
+    // There should still be enough groups to keep all threads busy.
+    const size_t group = ::std::min<size_t>(::std::max<size_t>(docs.size() / nthreads / 16, 1), 256);
+    const size_t ngroups = (docs.size() + group - 1) / group;
+    nthreads = static_cast<unsigned>(::std::min<size_t>(nthreads, ngroups));
+
+    // Get pointers before starting threads, so nothing is copied on write.
+    Value* const out = values.mut_data();
+    Parser_Context* const out_ctx = contexts.data();
+    ::std::vector<::std::exception_ptr> excepts(nthreads);
+    ::std::atomic<size_t> next_group(0);
+    ::std::atomic<bool> all_ok(true);
+
+    auto parse_groups = [&](::std::exception_ptr& except)
+      {
+        try {
+          Parser_Workspace work;
+          work.dict = dict;
+          for(;;) {
+            size_t k = next_group.fetch_add(1, ::std::memory_order_relaxed) * group;
+            if(k >= docs.size())
+              break;
+
+            for(size_t end = ::std::min(k + group, docs.size());  k != end;  ++k) {
+              Chunk_Source csrc(docs[k].bptr, docs[k].len, docs[k].boff);
+              do_parse_with(out[k], out_ctx[k], csrc, work, opts);
+              if(out_ctx[k].error)
+                all_ok.store(false, ::std::memory_order_relaxed);
+            }
+          }
+        }
+        catch(...)
+          { except = ::std::current_exception();  }
+      };
+
+    ::std::vector<::std::thread> threads;
+    threads.reserve(nthreads - 1);
+    while(threads.size() < nthreads - 1)
+      try {
+        threads.emplace_back(parse_groups, ::std::ref(excepts[threads.size() + 1]));
+      }
+      catch(::std::system_error&)
+        { break;  }
+
+    parse_groups(excepts[0]);
+    for(auto& thr : threads)
+      thr.join();
+
+    for(const auto& except : excepts)
+      if(except)
+        ::std::rethrow_exception(except);
+
+    return all_ok.load(::std::memory_order_relaxed);
+  }
+
+// This is a node of a tree of paths for projection. Node 0 is the root, and all
+// others are segments of paths, each of which matches a key of an object, or an
+// index of an array, or anything if it is an asterisk.
+struct Path_Node
+  {
+    ::asteria::cow_string seg;
+    int64_t index;  // if `seg` is a decimal number, its value; otherwise -1
+    uint32_t parent;
+    bool terminal;  // whether a path ends here
+  };
+
+void
+do_compile_paths(::std::vector<Path_Node>& nodes, const ::std::vector<V_string>& paths)
+  {
+    nodes.clear();
+    nodes.emplace_back();
+    nodes.back().index = -1;
+
+    for(const auto& path : paths) {
+      uint32_t cur = 0;
+      auto sptr = path.data();
+      const auto eptr = path.data() + path.size();
+      while(sptr != eptr) {
+        // Segments are separated by slashes.
+        sptr += *sptr == '/';
+        auto tptr = static_cast<const char*>(::std::memchr(sptr, '/', static_cast<size_t>(eptr - sptr)));
+        if(!tptr)
+          tptr = eptr;
+
+        size_t len = static_cast<size_t>(tptr - sptr);
+        uint32_t next = 0;
+        for(uint32_t k = 1;  k != nodes.size();  ++k)
+          if((nodes[k].parent == cur) && (nodes[k].seg.size() == len)
+             && ::asteria::xmemeq(nodes[k].seg.data(), sptr, len))
+            next = k;
+
+        if(next == 0) {
+          next = static_cast<uint32_t>(nodes.size());
+          auto& node = nodes.emplace_back();
+          node.seg.assign(sptr, len);
+          node.index = -1;
+          node.parent = cur;
+
+          if((len != 0) && (len <= 18) && ::std::all_of(sptr, tptr, [](char c) { return is_within(c, '0', '9');  })) {
+            node.index = 0;
+            for(auto p = sptr;  p != tptr;  ++p)
+              node.index = node.index * 10 + (*p - '0');
+          }
+        }
+
+        cur = next;
+        sptr = tptr;
+      }
+      nodes[cur].terminal = true;
+    }
+  }
+
+// Skips an array or an object whose opening bracket or brace has been parsed.
+// In indexed mode, only brackets and braces are counted, which is much faster,
+// but strings in between are neither decoded nor validated.
+void
+do_skip_container(Parser_Token& token, Parser_Context& ctx, Memory_Source& usrc, char open)
+  {
+    // Keep types of open arrays and objects in a stack of bits, where ones are
+    // objects. The innermost 64 levels are kept in `types`, and outer ones are
+    // spilled into `spilled`, so memory is only allocated for deep nesting.
+    uint64_t types = (open == '{');
+    uint32_t ntypes = 1;
+    ::std::vector<uint64_t> spilled;
+
+    for(;;) {
+      char ch;
+      if(usrc.index) {
+        if((usrc.iptr == usrc.ieptr) && !do_fill_index(usrc)) {
+          usrc.sptr = usrc.eptr;
+          ctx.saved_offset = usrc.tell();
+          break;
+        }
+
+        ch = usrc.bptr[*(usrc.iptr)];
+        usrc.iptr ++;
+        if(!is_any(ch, '[', '{', ']', '}'))
+          continue;
+
+        usrc.sptr = usrc.bptr + usrc.iptr[-1] + 1;
+        ctx.saved_offset = usrc.tell() - 1;
+      }
+      else {
+        do_token(token, ctx, usrc);
+        if(ctx.error)
+          return;
+        else if(token.empty())
+          break;
+
+        ch = token[0];
+        if(!is_any(ch, '[', '{', ']', '}'))
+          continue;
+      }
+
+      if(is_any(ch, '[', '{')) {
+        // open
+        if(ntypes == 64) {
+          spilled.push_back(types);
+          ntypes = 0;
+        }
+        types = (types << 1) | (ch == '{');
+        ntypes ++;
+        continue;
+      }
+
+      // The close bracket or brace must match the innermost open one.
+      if(ch != ((types & 1) ? '}' : ']'))
+        break;
+
+      types >>= 1;
+      ntypes --;
+      if(ntypes == 0) {
+        if(spilled.empty())
+          return;
+
+        types = spilled.back();
+        spilled.pop_back();
+        ntypes = 64;
+      }
+    }
+
+    // Either the end of input has been reached, or a close bracket or brace does
+    // not match. Both are reported on the innermost array or object.
+    return do_err(ctx, (types & 1) ? "Object not terminated properly"
+                                   : "Array not terminated properly");
+  }
+
+// Skips a value whose first token has not been parsed. In indexed mode, a string
+// is skipped to its closing quotation mark, without being decoded.
+void
+do_skip_value(Parser_Token& token, Parser_Context& ctx, Memory_Source& usrc, Options opts)
+  {
+    if(usrc.index && ((usrc.iptr != usrc.ieptr) || do_fill_index(usrc))
+       && (usrc.ieptr - usrc.iptr >= 2) && (usrc.bptr[*(usrc.iptr)] == '\"')) {
+      usrc.sptr = usrc.bptr + usrc.iptr[1] + 1;
+      usrc.iptr += 2;
+      return;
+    }
+
+    do_token(token, ctx, usrc);
+    if(ctx.eof)
+      return do_err(ctx, "Missing value");
+    else if(ctx.error)
+      return;
+
+    if(is_any(token[0], '[', '{'))
+      do_skip_container(token, ctx, usrc, token[0]);
+    else
+      do_classify_scalar(ctx, token, opts);
+  }
+
+// This builds parts of a value that are selected by `nodes`, and skips the others.
+// Each frame has a range of `active`, which is the set of nodes that match this
+// array or object. The set of the current value follows that of the innermost
+// frame.
+struct Projecting_Builder
+  {
+    struct xFrame
+      {
+        Value* target;
+        V_array* psa;
+        V_object* pso;
+        size_t count;  // elements of an array that have been taken
+        uint32_t abegin;
+        uint32_t aend;
+      };
+
+    Parser_Context* ctx;
+    Memory_Source* usrc;
+    Parser_Workspace* work;
+    const ::std::vector<Path_Node>* nodes;
+    Options opts;
+    Value* pstor;
+
+    ::std::vector<xFrame> stack;
+    ::std::vector<uint32_t> active = { 0 };
+    uint32_t abegin = 0;
+    uint32_t aend = 1;
+
+    size_t
+    depth()
+      const noexcept
+      {
+        return this->stack.size();
+      }
+
+    bool
+    at_top()
+      const noexcept
+      {
+        return this->stack.empty();
+      }
+
+    bool
+    in_array()
+      const noexcept
+      {
+        return this->stack.back().psa;
+      }
+
+    bool
+    do_value()
+      {
+        // If a path ends here, take the whole value.
+        for(uint32_t k = this->abegin;  k != this->aend;  ++k)
+          if((*(this->nodes))[this->active[k]].terminal) {
+            this->work->depth = this->stack.size();
+            do_parse_value(*(this->pstor), *(this->ctx), *(this->usrc), *(this->work), this->opts);
+            return false;
+          }
+
+        return true;
+      }
+
+    void
+    do_start(bool /*object*/)
+      noexcept
+      {
+      }
+
+    void
+    do_empty(bool object)
+      {
+        if(object)
+          this->pstor->open_object();
+        else
+          this->pstor->open_array();
+      }
+
+    void
+    do_push(bool object)
+      {
+        auto& frm = this->stack.emplace_back();
+        frm.target = this->pstor;
+        if(object)
+          frm.pso = &(this->pstor->open_object());
+        else
+          frm.psa = &(this->pstor->open_array());
+        frm.count = 0;
+        frm.abegin = this->abegin;
+        frm.aend = this->aend;
+      }
+
+    template<typename xPredicate>
+    void
+    do_match(const xFrame& frm, xPredicate&& pred)
+      {
+        // Drop nodes of the previous element or member, and find nodes that
+        // match this one.
+        this->active.resize(frm.aend);
+        this->abegin = static_cast<uint32_t>(this->active.size());
+        for(uint32_t k = 1;  k != this->nodes->size();  ++k) {
+          const auto& node = (*(this->nodes))[k];
+          auto bptr = this->active.begin();
+          if(::std::find(bptr + frm.abegin, bptr + frm.aend, node.parent) != bptr + frm.aend)
+            if((node.seg == "*") || pred(node))
+              this->active.push_back(k);
+        }
+
+        this->aend = static_cast<uint32_t>(this->active.size());
+      }
+
+    bool
+    do_element()
+      {
+        // Elements that are not selected are left as null.
+        auto& frm = this->stack.back();
+        auto is_match = [&](const Path_Node& node) {
+          return node.index == static_cast<int64_t>(frm.count);
+        };
+
+        this->do_match(frm, is_match);
+        this->pstor = &(frm.psa->emplace_back());
+        frm.count ++;
+
+        if(this->abegin != this->aend)
+          return true;
+
+        auto& token = this->work->token;
+        if(is_any(token[0], '[', '{'))
+          do_skip_container(token, *(this->ctx), *(this->usrc), token[0]);
+        else
+          do_classify_scalar(*(this->ctx), token, this->opts);
+        return false;
+      }
+
+    bool
+    do_member()
+      {
+        // Members that are not selected are omitted.
+        auto& frm = this->stack.back();
+        auto& token = this->work->token;
+        auto is_match = [&](const Path_Node& node) {
+          return (node.seg.size() == token.size() - 1)
+                 && ::asteria::xmemeq(node.seg.data(), token.data() + 1, token.size() - 1);
+        };
+
+        this->do_match(frm, is_match);
+
+        if(this->abegin == this->aend) {
+          do_token(token, *(this->ctx), *(this->usrc));
+          if(token[0] != ':') {
+            do_err(*(this->ctx), "Missing colon");
+            return false;
+          }
+
+          do_skip_value(token, *(this->ctx), *(this->usrc), this->opts);
+          return false;
+        }
+
+        auto emr = frm.pso->try_emplace(do_intern_string(this->work->key_pool, this->work->dict,
+                                                         token.data() + 1, token.size() - 1));
+        if(!emr.second) {
+          do_err(*(this->ctx), "Duplicate key string");
+          return false;
+        }
+
+        this->pstor = &(emr.first->second);
+        return true;
+      }
+
+    void
+    do_scalar()
+      {
+        // A path goes into a scalar value, which is not selected.
+        do_classify_scalar(*(this->ctx), this->work->token, this->opts);
+      }
+
+    void
+    do_pop()
+      {
+        this->pstor = this->stack.back().target;
+        this->stack.pop_back();
+      }
+  };
+
+// Parses a value, but only builds parts that are selected by `nodes`. This is
+// otherwise the same as `do_parse_with()`.
+void
+do_parse_projected(Value& root, Parser_Context& ctx, Memory_Source& usrc,
+                   const ::std::vector<Path_Node>& nodes, Options opts)
+  {
+    // Initialize parser state.
+    root.clear();
+    ::std::memset(&ctx, 0, sizeof(ctx));
+    ctx.c = -1;
+
+    Parser_Workspace work;
+    do_prepare_source(usrc, work);
+
+    do_token(work.token, ctx, usrc);
+    if(ctx.error)
+      return;
+
+    if(work.token.empty())
+      return do_err(ctx, "Blank input");
+
+    Projecting_Builder b = { &ctx, &usrc, &work, &nodes, opts, &root, ::std::vector<Projecting_Builder::xFrame>() };
+    do_drive_value(b, ctx, usrc, work.token, opts);
+  }
+
+constexpr ASTERIA_ALWAYS_INLINE
+bool
+is_scalar_char(int c)
+  {
+    return is_any(c, '_', '$', '+', '-', '.') || is_within(c, 'A', 'Z')
+           || is_within(c, 'a', 'z') || is_within(c, '0', '9');
+  }
+
+// This is the state of the background thread for deferred destruction.
+struct Reclaimer
+  {
+    ::std::mutex mutex;
+    ::std::condition_variable avail;  // signaled when a value is queued
+    ::std::condition_variable idle;   // signaled when the thread is idle or exits
+    ::std::vector<Value> queue;
+    ::std::thread thread;
+    bool running = false;
+    bool stopping = false;
+    Reclaimer_Stats stats = { };
+  };
+
+Reclaimer&
+do_get_reclaimer()
+  {
+    // This is never destroyed, as the thread may still be running at exit.
+    alignas(Reclaimer) static char s_storage[sizeof(Reclaimer)];
+    static Reclaimer* const s_reclaimer = ::new(s_storage) Reclaimer();
+    return *s_reclaimer;
+  }
+
+// Destroys a tree, and returns the number of values in it. Elements and members
+// that are shared with other values are not counted. Like the destructor, this
+// links containers through their first elements or members instead of using a
+// stack, so it allocates no memory, and cannot fail on the background thread.
+uint64_t
+do_destroy_tree(Value& root)
+  noexcept
+  {
+    uint64_t count = 0;
+    Value list;
+    Value cur;
+
+    auto get_first = [](Value& val) -> Value*
+      {
+        if(val.is_array() && val.as_array().unique() && !val.as_array().empty())
+          return &*(val.open_array_begin());
+        else if(val.is_object() && val.as_object().unique() && !val.as_object().empty())
+          return &(val.open_object_begin()->second);
+        else
+          return nullptr;
+      };
+
+    // A container that is linked leaves a null in its first element or member,
+    // which is counted in its place when the container is unlinked.
+    auto push = [&](Value& val)
+      {
+        while(Value* first = get_first(val)) {
+          first->swap(list);
+          val.swap(list);
+        }
+        count ++;
+      };
+
+    push(root);
+    while(!list.is_null()) {
+      // Unlink the first container.
+      Value* first = get_first(list);
+      cur.swap(list);
+      first->swap(list);
+
+      if(cur.is_array())
+        for(auto it = cur.open_array_begin();  it != cur.open_array_end();  ++it)
+          push(*it);
+      else
+        for(auto it = cur.open_object_begin();  it != cur.open_object_end();  ++it)
+          push(it->second);
+
+      cur.clear();
+    }
+
+    root.clear();
+    return count;
+  }
+
+void
+do_reclaim_loop(Reclaimer& r)
+  {
+#ifdef SCHED_IDLE
+    // Run only when the CPU would be idle otherwise.
+    ::sched_param param = { };
+    ::pthread_setschedparam(::pthread_self(), SCHED_IDLE, &param);
+#endif
+
+    ::std::vector<Value> batch;
+    ::std::unique_lock<::std::mutex> lock(r.mutex);
+    for(;;) {
+      if(r.queue.empty()) {
+        // Exit if there is nothing to do for a while.
+        r.idle.notify_all();
+        if(!r.avail.wait_for(lock, ::std::chrono::seconds(1),
+                             [&] { return !r.queue.empty() || r.stopping; })
+           || r.queue.empty()) {
+          r.running = false;
+          r.idle.notify_all();
+          return;
+        }
+      }
+
+      batch.swap(r.queue);
+      lock.unlock();
+
+      uint64_t nodes = 0;
+      for(auto& value : batch)
+        nodes += do_destroy_tree(value);
+
+      size_t count = batch.size();
+      batch.clear();
+
+      lock.lock();
+      r.stats.queue_depth -= count;
+      r.stats.reclaimed_values += count;
+      r.stats.reclaimed_nodes += nodes;
+    }
+  }
+
+}  // namespace
+
+// We assume that a all-bit-zero struct represents the `null` value.
+// This is effectively undefined behavior. Don't play with this at home!
+alignas(Value) const char null_storage[sizeof(Value)] = { };
+
+void
+Value::
+do_nonrecursive_destructor()
+  noexcept
+  {
+#ifdef ASTERIA_DEBUG
+    // Attempt to run out of stack in a rather stupid way.
+    static char* volatile s_stupid_begin;
+    static char* volatile s_stupid_end;
+
+    char stupid[1000] = { };
+    s_stupid_begin = stupid;
+    s_stupid_end = stupid + sizeof(stupid);
+
+    s_stupid_begin[0] = 1;
+    s_stupid_end[-1] = 2;
+#endif
+
+    // Break deep recursion without allocating memory. Arrays and objects that are
+    // not shared and not empty are put into a list, which is linked through their
+    // first elements or members; each first element or member is moved to where
+    // its container was. Containers are then taken from the list one by one, and
+    // their elements and members are handled likewise, after which they can be
+    // destroyed without recursion.
+    using bytes_type = ::std::aligned_storage<sizeof(m_stor), sizeof(void*)>::type;
+    Value list;
+    Value cur;
+
+    auto get_first = [](Value& val) -> Value*
+      {
+        switch(val.m_stor.index())
+          {
+          case t_array: {
+            auto& sa = val.m_stor.mut<V_array>();
+            if(sa.unique() && !sa.empty())
+              return sa.mut_begin();
+            break;
+          }
+
+          case t_object: {
+            auto& so = val.m_stor.mut<V_object>();
+            if(so.unique() && !so.empty())
+              return &(so.mut_begin()->second);
+            break;
+          }
+        }
+        return nullptr;
+      };
+
+    auto push = [&](Value& val)
+      {
+        while(Value* first = get_first(val)) {
+          first->swap(list);
+          val.swap(list);
+        }
+      };
+
+    push(*this);
+    while(list.m_stor.index() != t_null) {
+      // Unlink the first container.
+      Value* first = get_first(list);
+      cur.swap(list);
+      first->swap(list);
+
+      if(auto psa = cur.m_stor.mut_ptr<V_array>())
+        for(auto it = psa->mut_begin();  it != psa->mut_end();  ++it)
+          push(*it);
+      else if(auto pso = cur.m_stor.mut_ptr<V_object>())
+        for(auto it = pso->mut_begin();  it != pso->mut_end();  ++it)
+          push(it->second);
+
+      ::asteria::destroy(&(cur.m_stor));
+      reinterpret_cast<bytes_type&>(cur.m_stor) = bytes_type();
+    }
+
+    ::asteria::destroy(&(this->m_stor));
+    reinterpret_cast<bytes_type&>(this->m_stor) = bytes_type();
+  }
+
+void
+Value::
+shrink_to_fit()
+  {
+    ::std::vector<Value*> stack;
+    Value* pval = this;
+
+    for(;;) {
+      if(auto psa = pval->m_stor.mut_ptr<V_array>()) {
+        if(psa->unique()) {
+          psa->shrink_to_fit();
+          for(auto it = psa->mut_begin();  it != psa->mut_end();  ++it)
+            if(it->is_array() || it->is_object())
+              stack.push_back(&*it);
+        }
+      }
+      else if(auto pso = pval->m_stor.mut_ptr<V_object>()) {
+        if(pso->unique()) {
+          pso->shrink_to_fit();
+          for(auto it = pso->mut_begin();  it != pso->mut_end();  ++it)
+            if(it->second.is_array() || it->second.is_object())
+              stack.push_back(&(it->second));
+        }
+      }
+
+      if(stack.empty())
+        break;
+
+      pval = stack.back();
+      stack.pop_back();
+    }
+  }
+
+void
+Value::
+parse_with(Parser_Context& ctx, ::asteria::tinyfmt& fmt, Options opts)
+  {
+    Tinyfmt_Source tsrc(fmt);
+    do_parse_with(*this, ctx, tsrc, opts);
+  }
+
+void
+Value::
+parse_with(Parser_Context& ctx, const ::asteria::cow_string& str, Options opts)
+  {
+    Memory_Source msrc(str.data(), str.size());
+    do_parse_with(*this, ctx, msrc, opts);
+  }
+
+void
+Value::
+parse_with(Parser_Context& ctx, const ::asteria::linear_buffer& ln, Options opts)
+  {
+    Memory_Source msrc(ln.data(), ln.size());
+    do_parse_with(*this, ctx, msrc, opts);
+  }
+
+void
+Value::
+parse_with(Parser_Context& ctx, const char* str, size_t len, Options opts)
+  {
+    Memory_Source msrc(str, len);
+    do_parse_with(*this, ctx, msrc, opts);
+  }
+
+void
+Value::
+parse_with(Parser_Context& ctx, const char* str, Options opts)
+  {
+    Memory_Source msrc(str, ::strlen(str));
+    do_parse_with(*this, ctx, msrc, opts);
+  }
+
+void
+Value::
+parse_with(Parser_Context& ctx, ::std::FILE* fp, Options opts)
+  {
+    do_parse_file(*this, ctx, fp, opts);
+  }
+
+void
+Value::
+parse_with(Parser_Context& ctx, int fd, Options opts)
+  {
+    Buffered_Source bsrc(fd);
+    do_parse_with(*this, ctx, bsrc, opts);
+  }
+
+void
+Value::
+parse_with(Parser_Context& ctx, const Source_Ref& src, Options opts)
+  {
+    User_Source usrc(src);
+    do_parse_with(*this, ctx, usrc, opts);
+  }
+
+bool
+Value::
+parse(::asteria::tinyfmt& fmt, Options opts)
+  {
+    Parser_Context ctx;
+    Tinyfmt_Source tsrc(fmt);
+    do_parse_with(*this, ctx, tsrc, opts);
+    return !ctx.error;
+  }
+
+bool
+Value::
+parse(const ::asteria::cow_string& str, Options opts)
+  {
+    Parser_Context ctx;
+    Memory_Source msrc(str.data(), str.size());
+    do_parse_with(*this, ctx, msrc, opts);
+    return !ctx.error;
+  }
+
+bool
+Value::
+parse(const ::asteria::linear_buffer& ln, Options opts)
+  {
+    Parser_Context ctx;
+    Memory_Source msrc(ln.data(), ln.size());
+    do_parse_with(*this, ctx, msrc, opts);
+    return !ctx.error;
+  }
+
+bool
+Value::
+parse(const char* str, size_t len, Options opts)
+  {
+    Parser_Context ctx;
+    Memory_Source msrc(str, len);
+    do_parse_with(*this, ctx, msrc, opts);
+    return !ctx.error;
+  }
+
+bool
+Value::
+parse(const char* str, Options opts)
+  {
+    Parser_Context ctx;
+    Memory_Source msrc(str, ::strlen(str));
+    do_parse_with(*this, ctx, msrc, opts);
+    return !ctx.error;
+  }
+
+bool
+Value::
+parse(::std::FILE* fp, Options opts)
+  {
+    Parser_Context ctx;
+    do_parse_file(*this, ctx, fp, opts);
+    return !ctx.error;
+  }
+
+bool
+Value::
+parse(int fd, Options opts)
+  {
+    Parser_Context ctx;
+    Buffered_Source bsrc(fd);
+    do_parse_with(*this, ctx, bsrc, opts);
+    return !ctx.error;
+  }
+
+void
+Value::
+parse_file_with(Parser_Context& ctx, const char* path, Options opts)
+  {
+    do_parse_mapped_file(*this, ctx, path, opts);
+  }
+
+bool
+Value::
+parse_file(const char* path, Options opts)
+  {
+    Parser_Context ctx;
+    do_parse_mapped_file(*this, ctx, path, opts);
+    return !ctx.error;
+  }
+
+bool
+Value::
+parse(const Source_Ref& src, Options opts)
+  {
+    Parser_Context ctx;
+    User_Source usrc(src);
+    do_parse_with(*this, ctx, usrc, opts);
+    return !ctx.error;
+  }
+
+void
+Value::
+parse_with(Parser_Context& ctx, const char* str, size_t len, const ::std::vector<V_string>& paths,
+           Options opts)
+  {
+    ::std::vector<Path_Node> nodes;
+    do_compile_paths(nodes, paths);
+    Memory_Source msrc(str, len);
+    do_parse_projected(*this, ctx, msrc, nodes, opts);
+  }
+
+void
+Value::
+parse_with(Parser_Context& ctx, const ::asteria::cow_string& str, const ::std::vector<V_string>& paths,
+           Options opts)
+  {
+    this->parse_with(ctx, str.data(), str.size(), paths, opts);
+  }
+
+bool
+Value::
+parse(const char* str, size_t len, const ::std::vector<V_string>& paths, Options opts)
+  {
+    Parser_Context ctx;
+    this->parse_with(ctx, str, len, paths, opts);
+    return !ctx.error;
+  }
+
+bool
+Value::
+parse(const ::asteria::cow_string& str, const ::std::vector<V_string>& paths, Options opts)
+  {
+    Parser_Context ctx;
+    this->parse_with(ctx, str.data(), str.size(), paths, opts);
+    return !ctx.error;
+  }
+
+void
+Value::
+parse_parallel_with(Parser_Context& ctx, const char* str, size_t len, unsigned nthreads,
+                    Options opts)
+  {
+    if(nthreads == 0)
+      nthreads = ::std::max(::std::thread::hardware_concurrency(), 1U);
+
+    // Split the top-level array into chunks. There are more chunks than threads,
+    // so a thread that finishes early can take another one. Small inputs are not
+    // worth the overhead.
+    ::std::vector<const char*> splits;
+    if((nthreads > 1) && (len >= 1048576))
+      do_split_array(splits, str, str + len, ::std::min<size_t>(nthreads * 4U, len / 262144));
+
+    if(splits.empty()) {
+      Memory_Source msrc(str, len);
+      return do_parse_with(*this, ctx, msrc, opts);
+    }
+
+    struct xChunk
+      {
+        const char* bptr;
+        const char* eptr;
+        V_array values;
+        Parser_Context ctx;
+        ::std::exception_ptr except;
+      };
+
+    ::std::vector<xChunk> chunks(splits.size() + 1);
+    chunks.front().bptr = str;
+    for(size_t k = 0;  k != splits.size();  ++k) {
+      chunks[k].eptr = splits[k];
+      chunks[k+1].bptr = splits[k] + 1;
+    }
+    chunks.back().eptr = str + len;
+
+    // Each thread takes chunks in order, until there are none left. The calling
+    // thread takes part, so it still works if no thread can be created.
+    ::std::atomic<size_t> next_chunk(0);
+    auto parse_chunks = [&]
+      {
+        for(;;) {
+          size_t k = next_chunk.fetch_add(1, ::std::memory_order_relaxed);
+          if(k >= chunks.size())
+            break;
+
+          auto& chk = chunks[k];
+          try {
+            Chunk_Source csrc(chk.bptr, static_cast<size_t>(chk.eptr - chk.bptr), chk.bptr - str);
+            do_parse_chunk(chk.values, chk.ctx, csrc, k == 0, k == chunks.size() - 1, opts);
+          }
+          catch(...)
+            { chk.except = ::std::current_exception();  }
+        }
+      };
+
+    ::std::vector<::std::thread> threads;
+    threads.reserve(nthreads - 1);
+    while(threads.size() < nthreads - 1)
+      try {
+        threads.emplace_back(parse_chunks);
+      }
+      catch(::std::system_error&)
+        { break;  }
+
+    parse_chunks();
+    for(auto& thr : threads)
+      thr.join();
+
+    for(const auto& chk : chunks)
+      if(chk.except)
+        ::std::rethrow_exception(chk.except);
+
+    for(const auto& chk : chunks)
+      if(chk.ctx.error) {
+        // Parse the input again, so the error is the same as if it was parsed
+        // sequentially.
+        Memory_Source msrc(str, len);
+        return do_parse_with(*this, ctx, msrc, opts);
+      }
+
+    // Concatenate all elements.
+    size_t total = 0;
+    for(const auto& chk : chunks)
+      total += chk.values.size();
+
+    this->clear();
+    auto& arr = this->open_array();
+    arr.reserve(total);
+    for(auto& chk : chunks)
+      for(auto it = chk.values.mut_begin();  it != chk.values.end();  ++it)
+        arr.emplace_back().swap(*it);
+
+    ctx = chunks.back().ctx;
+  }
+
+bool
+Value::
+parse_parallel(const char* str, size_t len, unsigned nthreads, Options opts)
+  {
+    Parser_Context ctx;
+    this->parse_parallel_with(ctx, str, len, nthreads, opts);
+    return !ctx.error;
+  }
+
+void
+Value::
+print_to(::asteria::tinyfmt& fmt, Options opts)
+  const
+  {
+    do_print_to(Tinyfmt_Sink(fmt), *this, opts);
+  }
+
+void
+Value::
+print_to(::asteria::cow_string& str, Options opts)
+  const
+  {
+    do_print_to(String_Sink(str), *this, opts);
+  }
+
+void
+Value::
+print_to(::asteria::linear_buffer& ln, Options opts)
+  const
+  {
+    do_print_to(Buffer_Sink(ln), *this, opts);
+  }
+
+void
+Value::
+print_to(::std::FILE* fp, Options opts)
+  const
+  {
+    do_print_to(File_Sink(fp), *this, opts);
+  }
+
+void
+Value::
+print_to(const Sink_Ref& sink, Options opts)
+  const
+  {
+    do_print_to(User_Sink(sink), *this, opts);
+  }
+
+::asteria::cow_string
+Value::
+to_string(Options opts)
+  const
+  {
+    ::asteria::cow_string str;
+    do_print_to(String_Sink(str), *this, opts);
+    return str;
+  }
+
+void
+Value::
+print_to_stderr(Options opts)
+  const
+  {
+    do_print_to(File_Sink(stderr), *this, opts);
+  }
+
+void
+Push_Parser::
+reset(Options opts)
+  {
+    this->m_opts = opts;
+    this->m_state = state_value;
+    this->m_escaped = false;
+    ::std::memset(&(this->m_ctx), 0, sizeof(this->m_ctx));
+    this->m_ctx.c = -1;
+    this->m_offset = 0;
+    this->m_pending.clear();
+    this->m_stack.clear();
+    this->m_root.clear();
+    this->m_pstor = &(this->m_root);
+  }
+
+size_t
+Push_Parser::
+do_run(const char* data, size_t size, bool at_eof)
+  {
+    Chunk_Source csrc(data, size, this->m_offset);
+    Parser_Token token;
+    ::asteria::ascii_numget numg;
+    auto& ctx = this->m_ctx;
+    ctx.eof = false;
+
+    // This builds the tree on the stack of this parser, which is kept between
+    // chunks.
+    struct xBuilder
+      {
+        Push_Parser* parser;
+        const Parser_Token* token;
+        ::asteria::ascii_numget* numg;
+
+        size_t
+        depth()
+          const noexcept
+          {
+            return this->parser->m_stack.size();
+          }
+
+        bool
+        at_top()
+          const noexcept
+          {
+            return this->parser->m_stack.empty();
+          }
+
+        bool
+        in_array()
+          const noexcept
+          {
+            return this->parser->m_stack.back().psa;
+          }
+
+        bool
+        do_value()
+          noexcept
+          {
+            return true;
+          }
+
+        void
+        do_start(bool /*object*/)
+          noexcept
+          {
+          }
+
+        void
+        do_empty(bool object)
+          {
+            if(object)
+              this->parser->m_pstor->open_object();
+            else
+              this->parser->m_pstor->open_array();
+          }
+
+        void
+        do_push(bool object)
+          {
+            auto& frm = this->parser->m_stack.emplace_back();
+            frm.target = this->parser->m_pstor;
+            if(object)
+              frm.pso = &(this->parser->m_pstor->open_object());
+            else
+              frm.psa = &(this->parser->m_pstor->open_array());
+          }
+
+        bool
+        do_element()
+          {
+            this->parser->m_pstor = &(this->parser->m_stack.back().psa->emplace_back());
+            return true;
+          }
+
+        bool
+        do_member()
+          {
+            const auto& key = *(this->token);
+            auto emr = this->parser->m_stack.back().pso->try_emplace(
+                           ::asteria::phcow_string(::asteria::cow_string(key.data() + 1, key.size() - 1)));
+            if(!emr.second) {
+              do_err(this->parser->m_ctx, "Duplicate key string");
+              return false;
+            }
+
+            this->parser->m_pstor = &(emr.first->second);
+            return true;
+          }
+
+        void
+        do_scalar()
+          {
+            do_parse_scalar(*(this->parser->m_pstor), this->parser->m_ctx, *(this->token), *(this->numg),
+                            this->parser->m_opts);
+          }
+
+        void
+        do_pop()
+          {
+            this->parser->m_pstor = this->parser->m_stack.back().target;
+            this->parser->m_stack.pop_back();
+          }
+      };
+
+    xBuilder b = { this, &token, &numg };
+
+  do_token_loop_:
+    ctx.c = -1;
+    do_token(token, ctx, csrc);
+    const char* tbptr = data + (ctx.saved_offset - this->m_offset);
+
+    if(!at_eof && (csrc.sptr == csrc.eptr)
+       && (ctx.error || token.empty() || ((ctx.c < 0) && is_scalar_char(token[0])))) {
+      // The token may be continued in the next chunk, so save it. Strings are
+      // scanned for escape sequences, so `feed()` can tell whether a closing
+      // quotation mark is real.
+      this->m_pending.assign(tbptr, static_cast<size_t>(csrc.eptr - tbptr));
+      this->m_escaped = false;
+      if(!this->m_pending.empty() && (this->m_pending[0] == '\"'))
+        for(size_t k = 1;  k != this->m_pending.size();  ++k)
+          this->m_escaped = !this->m_escaped && (this->m_pending[k] == '\\');
+
+      ctx.error = nullptr;
+      ctx.eof = false;
+      this->m_offset = ctx.saved_offset;
+      return size;
+    }
+
+    if(ctx.error) {
+      this->m_state = state_error;
+      return static_cast<size_t>(tbptr - data);
+    }
+
+    if(token.empty()) {
+      // This is the end of input, so the value is incomplete.
+      ASTERIA_ASSERT(at_eof);
+      do_drive_end(b, ctx, this->m_state);
+      this->m_state = state_error;
+      return size;
+    }
+
+    if(ctx.c >= 0) {
+      // Return the lookahead character to the source, as it belongs to the next
+      // token, which will be parsed in the next iteration.
+      csrc.sptr -= 1 + (ctx.c > 0x7F) + (ctx.c > 0x7FF) + (ctx.c > 0xFFFF);
+      ctx.c = -1;
+    }
+
+    // Take only this token, and wait for the next one in the next iteration.
+    this->m_state = do_drive_tokens(b, ctx, token, this->m_state, this->m_opts, [] { return false;  });
+    if(this->m_state == state_error)
+      return static_cast<size_t>(tbptr - data);
+
+    if(this->m_state == state_done) {
+      // The value has been completed. Leave everything that follows for the
+      // caller.
+      this->m_offset += csrc.sptr - data;
+      return static_cast<size_t>(csrc.sptr - data);
+    }
+
+    goto do_token_loop_;
+  }
+
+size_t
+Push_Parser::
+feed(const char* data, size_t size)
+  {
+    if(this->m_state >= state_done)
+      return 0;
+
+    if(this->m_pending.empty())
+      return this->do_run(data, size, false);
+
+    // Check whether the pending token may end in this chunk. If not, append the
+    // chunk to it without parsing it again, so a long token that is split into
+    // many chunks takes linear time.
+    bool may_end = true;
+    if(this->m_pending[0] == '\"') {
+      may_end = false;
+      for(size_t k = 0;  (k != size) && !may_end;  ++k)
+        if(this->m_escaped)
+          this->m_escaped = false;
+        else if(data[k] == '\\')
+          this->m_escaped = true;
+        else
+          may_end = data[k] == '\"';
+    }
+    else if(is_scalar_char(this->m_pending[0]))
+      may_end = !::std::all_of(data, data + size, is_scalar_char);
+
+    size_t plen = this->m_pending.size();
+    this->m_pending.append(data, size);
+    if(!may_end)
+      return size;
+
+    ::asteria::cow_string buf;
+    buf.swap(this->m_pending);
+    size_t r = this->do_run(buf.data(), buf.size(), false);
+    return ::std::max(r, plen) - plen;
+  }
+
+void
+Push_Parser::
+finish()
+  {
+    if(this->m_state >= state_done)
+      return;
+
+    ::asteria::cow_string buf;
+    buf.swap(this->m_pending);
+    this->do_run(buf.data(), buf.size(), true);
+  }
+
+bool
+Push_Parser::
+done()
+  const noexcept
+  {
+    return this->m_state == state_done;
+  }
+
+void
+parse_stream_with(Parser_Context& ctx, const Callback_Ref& callback, const char* str, size_t len,
+                  Options opts)
+  {
+    Memory_Source msrc(str, len);
+    do_parse_stream(ctx, callback, msrc, opts);
+  }
+
+void
+parse_stream_with(Parser_Context& ctx, const Callback_Ref& callback, ::std::FILE* fp,
+                  Options opts)
+  {
+    if(::ftello(fp) >= 0) {
+      Buffered_Source bsrc(fp);
+      do_parse_stream(ctx, callback, bsrc, opts);
+    }
+    else {
+      File_Source fsrc(fp);
+      do_parse_stream(ctx, callback, fsrc, opts);
+    }
+  }
+
+void
+parse_stream_with(Parser_Context& ctx, const Callback_Ref& callback, int fd,
+                  Options opts)
+  {
+    Buffered_Source bsrc(fd);
+    do_parse_stream(ctx, callback, bsrc, opts);
+  }
+
+void
+parse_stream_with(Parser_Context& ctx, const Callback_Ref& callback, const Source_Ref& src,
+                  Options opts)
+  {
+    User_Source usrc(src);
+    do_parse_stream(ctx, callback, usrc, opts);
+  }
+
+bool
+parse_stream(V_array& values, const char* str, size_t len, Options opts)
+  {
+    Parser_Context ctx;
+    auto append = [&](Value& value) { values.emplace_back().swap(value);  };
+    parse_stream_with(ctx, Callback_Ref(append), str, len, opts);
+    return !ctx.error;
+  }
+
+bool
+parse_stream(V_array& values, ::std::FILE* fp, Options opts)
+  {
+    Parser_Context ctx;
+    auto append = [&](Value& value) { values.emplace_back().swap(value);  };
+    parse_stream_with(ctx, Callback_Ref(append), fp, opts);
+    return !ctx.error;
+  }
+
+bool
+parse_stream(V_array& values, int fd, Options opts)
+  {
+    Parser_Context ctx;
+    auto append = [&](Value& value) { values.emplace_back().swap(value);  };
+    parse_stream_with(ctx, Callback_Ref(append), fd, opts);
+    return !ctx.error;
+  }
+
+bool
+parse_stream(V_array& values, const Source_Ref& src, Options opts)
+  {
+    Parser_Context ctx;
+    auto append = [&](Value& value) { values.emplace_back().swap(value);  };
+    parse_stream_with(ctx, Callback_Ref(append), src, opts);
+    return !ctx.error;
+  }
 
-              usink.putn(temp, tlen);
-              bptr = tptr + mblen;
-            }
-          }
-        }
-    }
+bool
+parse_batch(V_array& values, ::std::vector<Parser_Context>& contexts, const ::asteria::cow_string* docs,
+            size_t count, unsigned nthreads, Options opts, Key_Dictionary* dict)
+  {
+    ::std::vector<Batch_Document> bdocs;
+    bdocs.reserve(count);
+    for(size_t k = 0;  k != count;  ++k)
+      bdocs.push_back({ docs[k].data(), docs[k].size(), 0 });
+
+    return do_parse_batch(values, contexts, bdocs, nthreads, opts, dict);
   }
 
-void
-do_print_to(const Unified_Sink& usink, const Value& root, Options opts)
+bool
+parse_batch(V_array& values, ::std::vector<Parser_Context>& contexts, const char* str, size_t len,
+            unsigned nthreads, Options opts, Key_Dictionary* dict)
   {
-    // Break deep recursion with a handwritten stack.
-    struct xFrame
-      {
-        const V_array* psa;
-        V_array::const_iterator ita;
-        const V_object* pso;
-        V_object::const_iterator ito;
-      };
+    // Each line that is not blank is a document. Line breaks are not allowed in
+    // strings, so they can be found without parsing anything.
+    ::std::vector<Batch_Document> bdocs;
+    auto bptr = str;
+    const auto eptr = str + len;
+    while(bptr != eptr) {
+      auto tptr = static_cast<const char*>(::std::memchr(bptr, '\n', static_cast<size_t>(eptr - bptr)));
+      if(!tptr)
+        tptr = eptr;
+
+      auto sptr = bptr;
+      while((sptr != tptr) && is_any(*sptr, ' ', '\t', '\r'))
+        ++ sptr;
+
+      if(sptr != tptr)
+        bdocs.push_back({ bptr, static_cast<size_t>(tptr - bptr), bptr - str });
+
+      bptr = tptr + (tptr != eptr);
+    }
 
-    ::std::vector<xFrame> stack;
-    ::asteria::ascii_numput nump;
-    const Value* pstor = &root;
+    return do_parse_batch(values, contexts, bdocs, nthreads, opts, dict);
+  }
 
-  do_unpack_loop_:
-    switch(pstor->type())
-      {
-      case t_null:
-        usink.putn("null", 4);
-        break;
+struct Key_Dictionary::xStorage
+  {
+    ::std::shared_mutex mutex;
+    Key_Pool keys;
+  };
 
-      case t_array:
-        if(!pstor->as_array().empty()) {
-          // open
-          auto& frm = stack.emplace_back();
-          frm.psa = &(pstor->as_array());
-          frm.ita = frm.psa->begin();
-          usink.putc('[');
-          pstor = &*(frm.ita);
-          goto do_unpack_loop_;
-        }
+Key_Dictionary::
+Key_Dictionary(size_t max_size, bool thread_safe)
+  : m_stor(new xStorage), m_max_size(max_size), m_thread_safe(thread_safe)
+  {
+  }
 
-        usink.putn("[]", 2);
-        break;
+Key_Dictionary::
+~Key_Dictionary()
+  {
+  }
 
-      case t_object:
-        if(!pstor->as_object().empty()) {
-          // open
-          auto& frm = stack.emplace_back();
-          frm.pso = &(pstor->as_object());
-          frm.ito = frm.pso->begin();
-          usink.putn("{\"", 2);
-          do_escape_string_utf16(usink, frm.ito->first.rdstr());
-          usink.putn("\":", 2);
-          pstor = &(frm.ito->second);
-          goto do_unpack_loop_;
-        }
+size_t
+Key_Dictionary::
+size()
+  const
+  {
+    ::std::shared_lock<::std::shared_mutex> lock(this->m_stor->mutex, ::std::defer_lock);
+    if(this->m_thread_safe)
+      lock.lock();
 
-        usink.putn("{}", 2);
-        break;
+    return this->m_stor->keys.size();
+  }
 
-      case t_boolean:
-        nump.put_TB(pstor->as_boolean());
-        usink.putn(nump.data(), nump.size());
-        break;
+::asteria::phcow_string
+Key_Dictionary::
+intern(const char* str, size_t len)
+  {
+    auto& keys = this->m_stor->keys;
+    size_t hval = ::asteria::phcow_string::hasher()(str, len);
 
-      case t_integer:
-        if(opts & option_json_mode) {
-          // as floating-point number; inaccurate for large values
-          nump.put_DD(static_cast<V_number>(pstor->as_integer()));
-          usink.putn(nump.data(), nump.size());
-        }
-        else {
-          // precise; annotated
-          nump.put_DI(pstor->as_integer());
-          usink.putn("\"$l:", 4);
-          usink.putn(nump.data(), nump.size());
-          usink.putc('\"');
-        }
-        break;
+    if(this->m_thread_safe) {
+      // Most keys should exist, so try a shared lock first.
+      ::std::shared_lock<::std::shared_mutex> lock(this->m_stor->mutex);
+      if(auto ptr = keys.find(hval, str, len))
+        return *ptr;
+      else if(keys.size() >= this->m_max_size)
+        return ::asteria::cow_string(str, len);
+    }
 
-      case t_number:
-        if(::std::isfinite(pstor->as_number())) {
-          // finite; unquoted
-          nump.put_DD(pstor->as_number());
-          usink.putn(nump.data(), nump.size());
-        }
-        else if(opts & option_json_mode) {
-          // invalid; nullified
-          usink.putn("null", 4);
-        }
-        else {
-          // non-finite; annotated
-          usink.putn("\"$d:", 4);
-          nump.put_DD(pstor->as_number());
-          usink.putn(nump.data(), nump.size());
-          usink.putc('\"');
-        }
-        break;
+    ::std::unique_lock<::std::shared_mutex> lock(this->m_stor->mutex, ::std::defer_lock);
+    if(this->m_thread_safe)
+      lock.lock();
 
-      case t_string:
-        if((opts & option_json_mode) || (pstor->as_string()[0] != '$')) {
-          // general; quoted
-          usink.putc('\"');
-          do_escape_string_utf16(usink, pstor->as_string());
-          usink.putc('\"');
-        }
-        else {
-          // starts with `$`; annotated
-          usink.putn("\"$s:", 4);
-          do_escape_string_utf16(usink, pstor->as_string());
-          usink.putc('\"');
-        }
-        break;
+    // The key may have been added by another thread.
+    if(auto ptr = keys.find(hval, str, len))
+      return *ptr;
+    else if(keys.size() >= this->m_max_size)
+      return ::asteria::cow_string(str, len);
 
-      case t_binary:
-        if(opts & option_json_mode) {
-          // invalid; nullified
-          usink.putn("null", 4);
-        }
-        else {
-          // annotated
-          auto bptr = pstor->as_binary().data();
-          const auto eptr = bptr + pstor->as_binary().size();
+    auto& sref = keys.insert(::asteria::cow_string(str, len));
+    ASTERIA_ASSERT(sref.rdhash() == hval);
+    return sref;
+  }
 
-          bool use_hex = true;
-          if(opts & option_bin_as_base64)
-            use_hex = false;
-          else
-            use_hex = (pstor->as_binary().size() <= 4)  // small
-                      || ((pstor->as_binary().size() % 4 == 0)
-                          && (pstor->as_binary().size() / 4 <= 8));
+void
+Key_Dictionary::
+clear()
+  {
+    ::std::unique_lock<::std::shared_mutex> lock(this->m_stor->mutex, ::std::defer_lock);
+    if(this->m_thread_safe)
+      lock.lock();
 
-          if(use_hex) {
-            // hex
-            usink.putn("\"$h:", 4);
+    this->m_stor->keys.clear();
+  }
 
-            const auto hex_digit = [](uint64_t b)
-              {
-                if(b < 10)
-                  return static_cast<char>('0' + b);
-                else
-                  return static_cast<char>('a' + b - 10);
-              };
+struct Parser::xWorkspace
+  : Parser_Workspace
+  {
+  };
 
-            while(eptr - bptr >= 8) {
-              // 8-byte group
-              char hex_word[16];
-              uint64_t word = ::asteria::load_be<uint64_t>(bptr);
-              bptr += 8;
+Parser::
+Parser(Key_Dictionary* dict)
+  : m_work(new xWorkspace)
+  {
+    this->m_work->dict = dict;
+  }
 
-              for(uint32_t t = 0;  t != 16;  ++t) {
-                hex_word[t] = hex_digit(word >> 60);
-                word <<= 4;
-              }
+Parser::
+~Parser()
+  {
+  }
 
-              usink.putn(hex_word, 16);
-            }
+void
+Parser::
+parse_with(Value& root, Parser_Context& ctx, ::asteria::tinyfmt& fmt, Options opts)
+  {
+    Tinyfmt_Source tsrc(fmt);
+    do_parse_with(root, ctx, tsrc, *(this->m_work), opts);
+  }
 
-            if(bptr != eptr) {
-              // <=7-byte group
-              char hex_word[16];
-              uint64_t word = 0;
-              size_t nrem = static_cast<size_t>(eptr - bptr);
-              for(uint32_t t = 0;  t != nrem;  ++t) {
-                word <<= 8;
-                word |= static_cast<uint64_t>(*bptr) << (64 - nrem * 8);
-                bptr ++;
-              }
+void
+Parser::
+parse_with(Value& root, Parser_Context& ctx, const ::asteria::cow_string& str, Options opts)
+  {
+    Memory_Source msrc(str.data(), str.size());
+    do_parse_with(root, ctx, msrc, *(this->m_work), opts);
+  }
 
-              for(uint32_t t = 0;  t != nrem * 2;  ++t) {
-                hex_word[t] = hex_digit(word >> 60);
-                word <<= 4;
-              }
+void
+Parser::
+parse_with(Value& root, Parser_Context& ctx, const ::asteria::linear_buffer& ln, Options opts)
+  {
+    Memory_Source msrc(ln.data(), ln.size());
+    do_parse_with(root, ctx, msrc, *(this->m_work), opts);
+  }
 
-              usink.putn(hex_word, nrem * 2);
-            }
-          }
-          else {
-            // base64
-            usink.putn("\"$b:", 4);
+void
+Parser::
+parse_with(Value& root, Parser_Context& ctx, const char* str, size_t len, Options opts)
+  {
+    Memory_Source msrc(str, len);
+    do_parse_with(root, ctx, msrc, *(this->m_work), opts);
+  }
 
-            const auto base64_digit = [](uint32_t b)
-              {
-                if(b < 26)
-                  return static_cast<char>('A' + b);
-                else if(b < 52)
-                  return static_cast<char>('a' + b - 26);
-                else if(b < 62)
-                  return static_cast<char>('0' + b - 52);
-                else if(b < 63)
-                  return '+';
-                else
-                  return '/';
-              };
+void
+Parser::
+parse_with(Value& root, Parser_Context& ctx, const char* str, Options opts)
+  {
+    Memory_Source msrc(str, ::strlen(str));
+    do_parse_with(root, ctx, msrc, *(this->m_work), opts);
+  }
 
-            while(eptr - bptr >= 3) {
-              // 3-byte group
-              char b64_word[4];
-              uint32_t word = ::asteria::load_be<uint32_t>(bptr);  // use the null terminator!
-              bptr += 3;
+void
+Parser::
+parse_with(Value& root, Parser_Context& ctx, const Source_Ref& src, Options opts)
+  {
+    User_Source usrc(src);
+    do_parse_with(root, ctx, usrc, *(this->m_work), opts);
+  }
 
-              for(uint32_t t = 0;  t != 4;  ++t) {
-                b64_word[t] = base64_digit(word >> 26);
-                word <<= 6;
-              }
+bool
+Parser::
+parse(Value& root, ::asteria::tinyfmt& fmt, Options opts)
+  {
+    Parser_Context ctx;
+    this->parse_with(root, ctx, fmt, opts);
+    return !ctx.error;
+  }
 
-              usink.putn(b64_word, 4);
-            }
+bool
+Parser::
+parse(Value& root, const ::asteria::cow_string& str, Options opts)
+  {
+    Parser_Context ctx;
+    this->parse_with(root, ctx, str, opts);
+    return !ctx.error;
+  }
 
-            if(bptr != eptr) {
-              // 1-byte or 2-byte group
-              size_t nrem = static_cast<size_t>(eptr - bptr);
-              char b64_word[4] = { 0, 0, '=', '=' };
-              uint32_t word = ::asteria::load_be<uint16_t>(bptr);  // use the null terminator!
-              bptr += nrem;
+bool
+Parser::
+parse(Value& root, const ::asteria::linear_buffer& ln, Options opts)
+  {
+    Parser_Context ctx;
+    this->parse_with(root, ctx, ln, opts);
+    return !ctx.error;
+  }
 
-              for(uint32_t t = 0;  t != nrem + 1;  ++t) {
-                b64_word[t] = base64_digit(word >> 10 & 0x3F);
-                word <<= 6;
-              }
+bool
+Parser::
+parse(Value& root, const char* str, size_t len, Options opts)
+  {
+    Parser_Context ctx;
+    this->parse_with(root, ctx, str, len, opts);
+    return !ctx.error;
+  }
 
-              usink.putn(b64_word, 4);
-            }
-          }
-          usink.putc('\"');
-        }
-        break;
+bool
+Parser::
+parse(Value& root, const char* str, Options opts)
+  {
+    Parser_Context ctx;
+    this->parse_with(root, ctx, str, opts);
+    return !ctx.error;
+  }
 
-      case t_time:
-        if(opts & option_json_mode) {
-          // invalid; nullified
-          usink.putn("null", 4);
-        }
-        else {
-          // annotated
-          nump.put_DI(::std::chrono::time_point_cast<::std::chrono::milliseconds>(
-                                pstor->as_time()).time_since_epoch().count());
-          usink.putn("\"$t:", 4);
-          usink.putn(nump.data(), nump.size());
-          usink.putc('\"');
-        }
-        break;
+bool
+Parser::
+parse(Value& root, const Source_Ref& src, Options opts)
+  {
+    Parser_Context ctx;
+    this->parse_with(root, ctx, src, opts);
+    return !ctx.error;
+  }
+
+void
+Parser::
+clear()
+  noexcept
+  {
+    auto& work = *(this->m_work);
+    ::std::vector<Parser_Workspace::xFrame>().swap(work.stack);
+    work.token.clear();
+    ::asteria::cow_string().swap(work.token.str);
+    work.key_pool.clear();
+    ::std::vector<::std::vector<::asteria::phcow_string>>().swap(work.shapes);
+    work.index = Structural_Index();
+  }
 
-      default:
-        ::asteria::sprintf_and_throw<::std::invalid_argument>(
-              "taxon::Value: unknown type enumeration `%d`", pstor->type());
-      }
+void
+defer_destroy(Value&& value)
+  {
+    Value temp;
+    temp.swap(value);
+    if(!(temp.is_array() && temp.as_array().unique())
+       && !(temp.is_object() && temp.as_object().unique()))
+      return;
 
-    while(!stack.empty()) {
-      auto& frm = stack.back();
-      if(frm.psa) {
-        // array
-        if(++ frm.ita != frm.psa->end()) {
-          // next
-          usink.putc(',');
-          pstor = &*(frm.ita);
-          goto do_unpack_loop_;
-        }
+    auto& r = do_get_reclaimer();
+    ::std::unique_lock<::std::mutex> lock(r.mutex);
+    if(!r.running) {
+      // The previous thread has exited, or is about to exit.
+      if(r.thread.joinable())
+        r.thread.join();
 
-        // end
-        usink.putc(']');
+      try {
+        r.thread = ::std::thread(do_reclaim_loop, ::std::ref(r));
       }
-      else {
-        // object
-        if(++ frm.ito != frm.pso->end()) {
-          // next
-          usink.putn(",\"", 2);
-          do_escape_string_utf16(usink, frm.ito->first.rdstr());
-          usink.putn("\":", 2);
-          pstor = &(frm.ito->second);
-          goto do_unpack_loop_;
-        }
+      catch(::std::system_error&)
+        { return;  }  // destroy it on this thread
+      r.running = true;
+    }
 
-        // end
-        usink.putc('}');
-      }
+    r.queue.emplace_back().swap(temp);
+    r.stats.queue_depth ++;
+    r.avail.notify_one();
+  }
 
-      // close
-      stack.pop_back();
-    }
+void
+flush_deferred()
+  {
+    auto& r = do_get_reclaimer();
+    ::std::unique_lock<::std::mutex> lock(r.mutex);
+    r.stopping = true;
+    r.avail.notify_one();
+    r.idle.wait(lock, [&] { return !r.running;  });
+    r.stopping = false;
+
+    if(r.thread.joinable())
+      r.thread.join();
+
+    // Release the queue, which is empty.
+    ::std::vector<Value>().swap(r.queue);
   }
 
-}  // namespace
+Reclaimer_Stats
+get_reclaimer_stats()
+  {
+    auto& r = do_get_reclaimer();
+    ::std::unique_lock<::std::mutex> lock(r.mutex);
+    return r.stats;
+  }
 
-// We assume that a all-bit-zero struct represents the `null` value.
-// This is effectively undefined behavior. Don't play with this at home!
-alignas(Value) const char null_storage[sizeof(Value)] = { };
+Event_Handler::
+~Event_Handler()
+  {
+  }
 
 void
-Value::
-do_nonrecursive_destructor()
-  noexcept
+Event_Handler::
+on_start_array()
   {
-#ifdef ASTERIA_DEBUG
-    // Attempt to run out of stack in a rather stupid way.
-    static char* volatile s_stupid_begin;
-    static char* volatile s_stupid_end;
+  }
 
-    char stupid[1000] = { };
-    s_stupid_begin = stupid;
-    s_stupid_end = stupid + sizeof(stupid);
+void
+Event_Handler::
+on_end_array()
+  {
+  }
 
-    s_stupid_begin[0] = 1;
-    s_stupid_end[-1] = 2;
-#endif
+void
+Event_Handler::
+on_start_object()
+  {
+  }
 
-    // Break deep recursion with a handwritten stack.
-    using bytes_type = ::std::aligned_storage<sizeof(m_stor), sizeof(void*)>::type;
-    ::std::vector<bytes_type> stack;
+void
+Event_Handler::
+on_end_object()
+  {
+  }
 
-  do_unpack_loop_:
-    switch(this->m_stor.index())
-      {
-      case t_array:
-        try {
-          auto& sa = this->m_stor.mut<V_array>();
-          if(sa.unique())
-            for(auto it = sa.mut_begin();  it != sa.end();  ++it)
-              ::std::swap(stack.emplace_back(), reinterpret_cast<bytes_type&>(it->m_stor));
-        }
-        catch(::std::exception& stdex)
-          { ::std::fprintf(stderr, "WARNING: %s\n", stdex.what());  }
-        break;
+void
+Event_Handler::
+on_key(const char*, size_t)
+  {
+  }
 
-      case t_object:
-        try {
-          auto& so = this->m_stor.mut<V_object>();
-          if(so.unique())
-            for(auto it = so.mut_begin();  it != so.end();  ++it)
-              ::std::swap(stack.emplace_back(), reinterpret_cast<bytes_type&>(it->second.m_stor));
-        }
-        catch(::std::exception& stdex)
-          { ::std::fprintf(stderr, "WARNING: %s\n", stdex.what());  }
-        break;
-      }
+void
+Event_Handler::
+on_null()
+  {
+  }
 
-    ::asteria::destroy(&(this->m_stor));
-    reinterpret_cast<bytes_type&>(this->m_stor) = bytes_type();
+void
+Event_Handler::
+on_boolean(bool)
+  {
+  }
 
-    if(!stack.empty()) {
-      reinterpret_cast<bytes_type&>(this->m_stor) = stack.back();
-      stack.pop_back();
-      goto do_unpack_loop_;
-    }
+void
+Event_Handler::
+on_integer(int64_t)
+  {
   }
 
 void
-Value::
-parse_with(Parser_Context& ctx, ::asteria::tinyfmt& fmt, Options opts)
+Event_Handler::
+on_number(double)
   {
-    do_parse_with(*this, ctx, &fmt, opts);
   }
 
 void
-Value::
-parse_with(Parser_Context& ctx, const ::asteria::cow_string& str, Options opts)
+Event_Handler::
+on_string(const char*, size_t)
   {
-    Memory_Source msrc(str.data(), str.size());
-    do_parse_with(*this, ctx, &msrc, opts);
   }
 
 void
-Value::
-parse_with(Parser_Context& ctx, const ::asteria::linear_buffer& ln, Options opts)
+Event_Handler::
+on_binary(const unsigned char*, size_t)
   {
-    Memory_Source msrc(ln.data(), ln.size());
-    do_parse_with(*this, ctx, &msrc, opts);
   }
 
 void
-Value::
-parse_with(Parser_Context& ctx, const char* str, size_t len, Options opts)
+Event_Handler::
+on_time(V_time)
+  {
+  }
+
+void
+parse_events_with(Parser_Context& ctx, Event_Handler& handler, const char* str, size_t len,
+                  Options opts)
   {
     Memory_Source msrc(str, len);
-    do_parse_with(*this, ctx, &msrc, opts);
+    do_parse_events(ctx, handler, msrc, opts);
   }
 
 void
-Value::
-parse_with(Parser_Context& ctx, const char* str, Options opts)
+parse_events_with(Parser_Context& ctx, Event_Handler& handler, ::std::FILE* fp,
+                  Options opts)
   {
-    Memory_Source msrc(str, ::strlen(str));
-    do_parse_with(*this, ctx, &msrc, opts);
+    if(::ftello(fp) >= 0) {
+      Buffered_Source bsrc(fp);
+      do_parse_events(ctx, handler, bsrc, opts);
+    }
+    else {
+      File_Source fsrc(fp);
+      do_parse_events(ctx, handler, fsrc, opts);
+    }
   }
 
 void
-Value::
-parse_with(Parser_Context& ctx, ::std::FILE* fp, Options opts)
+parse_events_with(Parser_Context& ctx, Event_Handler& handler, int fd,
+                  Options opts)
+  {
+    Buffered_Source bsrc(fd);
+    do_parse_events(ctx, handler, bsrc, opts);
+  }
+
+void
+parse_events_with(Parser_Context& ctx, Event_Handler& handler, const Source_Ref& src,
+                  Options opts)
   {
-    do_parse_with(*this, ctx, fp, opts);
+    User_Source usrc(src);
+    do_parse_events(ctx, handler, usrc, opts);
   }
 
 bool
-Value::
-parse(::asteria::tinyfmt& fmt, Options opts)
+parse_events(Event_Handler& handler, const char* str, size_t len, Options opts)
   {
     Parser_Context ctx;
-    do_parse_with(*this, ctx, &fmt, opts);
+    parse_events_with(ctx, handler, str, len, opts);
     return !ctx.error;
   }
 
 bool
-Value::
-parse(const ::asteria::cow_string& str, Options opts)
+parse_events(Event_Handler& handler, ::std::FILE* fp, Options opts)
   {
     Parser_Context ctx;
-    Memory_Source msrc(str.data(), str.size());
-    do_parse_with(*this, ctx, &msrc, opts);
+    parse_events_with(ctx, handler, fp, opts);
     return !ctx.error;
   }
 
 bool
-Value::
-parse(const ::asteria::linear_buffer& ln, Options opts)
+parse_events(Event_Handler& handler, int fd, Options opts)
   {
     Parser_Context ctx;
-    Memory_Source msrc(ln.data(), ln.size());
-    do_parse_with(*this, ctx, &msrc, opts);
+    parse_events_with(ctx, handler, fd, opts);
     return !ctx.error;
   }
 
 bool
-Value::
-parse(const char* str, size_t len, Options opts)
+parse_events(Event_Handler& handler, const Source_Ref& src, Options opts)
   {
     Parser_Context ctx;
-    Memory_Source msrc(str, len);
-    do_parse_with(*this, ctx, &msrc, opts);
+    parse_events_with(ctx, handler, src, opts);
     return !ctx.error;
   }
 
+void
+Document::
+do_build_tape(Parser_Context& ctx, size_t len)
+  {
+    // Initialize parser state.
+    ::std::memset(&ctx, 0, sizeof(ctx));
+    ctx.c = -1;
+    this->m_tape.clear();
+
+    if(len > UINT32_MAX)
+      return do_err(ctx, "Input too large");
+
+    Memory_Source msrc(this->m_bptr, len);
+    Parser_Workspace work;
+    do_prepare_source(msrc, work);
+
+    // Each value is appended to the tape before its descendants, and its `next`
+    // field is set after all of them. Open arrays and objects are kept in a stack
+    // of their indices.
+    struct xBuilder
+      {
+        Parser_Context* ctx;
+        Memory_Source* msrc;
+        Parser_Workspace* work;
+        ::std::vector<xEntry>* tape;
+        Options opts;
+        ::std::vector<uint32_t>* stack;
+        uint32_t index;  // the value that is being parsed
+
+        size_t
+        depth()
+          const noexcept
+          {
+            return this->stack->size();
+          }
+
+        bool
+        at_top()
+          const noexcept
+          {
+            return this->stack->empty();
+          }
+
+        bool
+        in_array()
+          const noexcept
+          {
+            return (*(this->tape))[this->stack->back()].type == t_array;
+          }
+
+        bool
+        do_value()
+          {
+            this->index = static_cast<uint32_t>(this->tape->size());
+            this->tape->emplace_back().offset = static_cast<uint32_t>(this->ctx->saved_offset);
+            return true;
+          }
+
+        void
+        do_start(bool object)
+          {
+            (*(this->tape))[this->index].type = object ? t_object : t_array;
+          }
+
+        void
+        do_empty(bool /*object*/)
+          {
+            auto& ent = (*(this->tape))[this->index];
+            ent.end = static_cast<uint32_t>(do_token_end(*(this->ctx), *(this->msrc)));
+            ent.next = this->index + 1;
+          }
+
+        void
+        do_push(bool /*object*/)
+          {
+            this->stack->push_back(this->index);
+          }
+
+        bool
+        do_element()
+          {
+            (*(this->tape))[this->stack->back()].size ++;
+            return true;
+          }
+
+        bool
+        do_member()
+          {
+            (*(this->tape))[this->stack->back()].size ++;
+            auto& key = this->tape->emplace_back();
+            key.offset = static_cast<uint32_t>(this->ctx->saved_offset);
+            key.end = static_cast<uint32_t>(do_token_end(*(this->ctx), *(this->msrc)));
+            key.next = static_cast<uint32_t>(this->tape->size());
+            key.type = t_string;
+            return true;
+          }
+
+        void
+        do_scalar()
+          {
+            auto& ent = (*(this->tape))[this->index];
+            ent.type = do_classify_scalar(*(this->ctx), this->work->token, this->opts);
+            if(this->ctx->error)
+              return;
+
+            ent.end = static_cast<uint32_t>(do_token_end(*(this->ctx), *(this->msrc)));
+            ent.next = this->index + 1;
+          }
+
+        void
+        do_pop()
+          {
+            auto& ent = (*(this->tape))[this->stack->back()];
+            ent.end = static_cast<uint32_t>(do_token_end(*(this->ctx), *(this->msrc)));
+            ent.next = static_cast<uint32_t>(this->tape->size());
+            this->stack->pop_back();
+          }
+      };
+
+    do_token(work.token, ctx, msrc);
+    if(ctx.error)
+      return;
+
+    if(work.token.empty())
+      return do_err(ctx, "Blank input");
+
+    ::std::vector<uint32_t> stack;
+    xBuilder b = { &ctx, &msrc, &work, &(this->m_tape), this->m_opts, &stack, 0 };
+    do_drive_value(b, ctx, msrc, work.token, this->m_opts);
+  }
+
+void
+Document::
+parse_with(Parser_Context& ctx, const char* str, size_t len, Options opts)
+  {
+    this->m_str.clear();
+    this->m_bptr = str;
+    this->m_opts = opts;
+    this->do_build_tape(ctx, len);
+    if(ctx.error)
+      this->m_tape.clear();
+  }
+
+void
+Document::
+parse_with(Parser_Context& ctx, const ::asteria::cow_string& str, Options opts)
+  {
+    this->m_str = str;
+    this->m_bptr = this->m_str.data();
+    this->m_opts = opts;
+    this->do_build_tape(ctx, this->m_str.size());
+    if(ctx.error)
+      this->m_tape.clear();
+  }
+
 bool
-Value::
-parse(const char* str, Options opts)
+Document::
+parse(const char* str, size_t len, Options opts)
   {
     Parser_Context ctx;
-    Memory_Source msrc(str, ::strlen(str));
-    do_parse_with(*this, ctx, &msrc, opts);
+    this->parse_with(ctx, str, len, opts);
     return !ctx.error;
   }
 
 bool
-Value::
-parse(::std::FILE* fp, Options opts)
+Document::
+parse(const ::asteria::cow_string& str, Options opts)
   {
     Parser_Context ctx;
-    do_parse_with(*this, ctx, fp, opts);
+    this->parse_with(ctx, str, opts);
     return !ctx.error;
   }
 
-void
-Value::
-print_to(::asteria::tinyfmt& fmt, Options opts)
-  const
+Type
+Lazy_Value::
+type()
+  const noexcept
   {
-    do_print_to(&fmt, *this, opts);
+    if(!this->m_doc)
+      return t_null;
+
+    return this->m_doc->m_tape[this->m_index].type;
   }
 
-void
-Value::
-print_to(::asteria::cow_string& str, Options opts)
+size_t
+Lazy_Value::
+size()
+  const noexcept
+  {
+    if(!this->m_doc)
+      return 0;
+
+    return this->m_doc->m_tape[this->m_index].size;
+  }
+
+Lazy_Value
+Lazy_Value::
+at(size_t index)
   const
   {
-    do_print_to(&str, *this, opts);
+    if(index >= this->size())
+      ::asteria::sprintf_and_throw<::std::out_of_range>(
+            "taxon::Lazy_Value: index `%lld` out of range", static_cast<long long>(index));
+
+    // Skip elements before the target. In an object, each member consists of a
+    // key followed by its value.
+    const auto& tape = this->m_doc->m_tape;
+    uint32_t kstep = tape[this->m_index].type == t_object;
+    uint32_t k = this->m_index + 1;
+    for(size_t i = 0;  i != index;  ++i)
+      k = tape[k + kstep].next;
+
+    return Lazy_Value(this->m_doc, k + kstep);
   }
 
-void
-Value::
-print_to(::asteria::linear_buffer& ln, Options opts)
+V_string
+Lazy_Value::
+key_at(size_t index)
   const
   {
-    do_print_to(&ln, *this, opts);
+    if((this->type() != t_object) || (index >= this->size()))
+      ::asteria::sprintf_and_throw<::std::out_of_range>(
+            "taxon::Lazy_Value: key index `%lld` out of range", static_cast<long long>(index));
+
+    const auto& tape = this->m_doc->m_tape;
+    uint32_t k = this->m_index + 1;
+    for(size_t i = 0;  i != index;  ++i)
+      k = tape[k + 1].next;
+
+    Parser_Token token;
+    do_decode_key(token, this->m_doc->m_bptr + tape[k].offset, tape[k].end - tape[k].offset);
+    return V_string(token.data() + 1, token.size() - 1);
   }
 
-void
-Value::
-print_to(::std::FILE* fp, Options opts)
+bool
+Lazy_Value::
+find(const char* key, size_t len, Lazy_Value& value)
   const
   {
-    do_print_to(fp, *this, opts);
+    if(this->type() != t_object)
+      return false;
+
+    const auto& tape = this->m_doc->m_tape;
+    Parser_Token token;
+    uint32_t k = this->m_index + 1;
+    for(size_t i = 0;  i != tape[this->m_index].size;  ++i) {
+      // Compare keys without escape sequences in place.
+      const char* kptr = this->m_doc->m_bptr + tape[k].offset;
+      size_t klen = tape[k].end - tape[k].offset;
+      if(::std::memchr(kptr, '\\', klen)) {
+        do_decode_key(token, kptr, klen);
+        kptr = token.data();
+        klen = token.size() + 1;
+      }
+
+      if((klen - 2 == len) && ::asteria::xmemeq(kptr + 1, key, len)) {
+        value = Lazy_Value(this->m_doc, k + 1);
+        return true;
+      }
+
+      k = tape[k + 1].next;
+    }
+    return false;
   }
 
-::asteria::cow_string
-Value::
-to_string(Options opts)
+const char*
+Lazy_Value::
+raw_data()
+  const noexcept
+  {
+    if(!this->m_doc)
+      return "";
+
+    return this->m_doc->m_bptr + this->m_doc->m_tape[this->m_index].offset;
+  }
+
+size_t
+Lazy_Value::
+raw_size()
+  const noexcept
+  {
+    if(!this->m_doc)
+      return 0;
+
+    const auto& ent = this->m_doc->m_tape[this->m_index];
+    return ent.end - ent.offset;
+  }
+
+Value
+Lazy_Value::
+to_value()
   const
   {
-    ::asteria::cow_string str;
-    do_print_to(&str, *this, opts);
-    return str;
+    Value value;
+    if(!this->m_doc)
+      return value;
+
+    // Parse the source text again, which has been validated except annotated
+    // strings and keys.
+    Parser_Context ctx;
+    Memory_Source msrc(this->raw_data(), this->raw_size());
+    do_parse_with(value, ctx, msrc, this->m_doc->m_opts);
+    if(ctx.error)
+      ::asteria::sprintf_and_throw<::std::invalid_argument>(
+            "taxon::Lazy_Value: %s at offset `%lld`", ctx.error,
+            static_cast<long long>(this->m_doc->m_tape[this->m_index].offset + ctx.offset));
+
+    return value;
   }
 
 void
-Value::
-print_to_stderr(Options opts)
-  const
+validate_with(Parser_Context& ctx, const char* str, size_t len, Options opts)
+  {
+    Validating_Handler handler(ctx);
+    Memory_Source msrc(str, len);
+    do_parse_events(ctx, handler, msrc, opts);
+  }
+
+bool
+validate(const char* str, size_t len, Options opts)
   {
-    do_print_to(stderr, *this, opts);
+    Parser_Context ctx;
+    validate_with(ctx, str, len, opts);
+    return !ctx.error;
   }
 
 }  // namespace taxon
@@ -11,7 +11,10 @@
 #include <asteria/rocket/variant.hpp>
 #include <asteria/rocket/linear_buffer.hpp>
 #include <asteria/rocket/tinyfmt.hpp>
+#include <vector>
 #include <chrono>
+#include <memory>
+#include <type_traits>
 namespace taxon {
 
 using ::std::int8_t;
@@ -31,7 +34,13 @@ using ::std::initializer_list;
 
 enum Options : uint32_t;
 struct Parser_Context;
+struct Source_Ref;
+struct Sink_Ref;
+struct Callback_Ref;
 class Value;
+class Document;
+class Lazy_Value;
+class Key_Dictionary;
 
 // Define aliases and enumerators for data types.
 // - scalar
@@ -108,6 +117,76 @@ struct Parser_Context
     int64_t saved_offset;
   };
 
+// These structures allow user-defined sources and sinks. A source is an object
+// of any class with these public member functions:
+//
+//   int getc();                      // returns the next byte, or -1 at the end
+//   size_t getn(char* s, size_t n);  // reads at most `n` bytes, and returns the
+//                                    // number of bytes that have been read
+//   int64_t tell() const;            // returns the offset of the next byte
+//
+// A sink is an object of any class with these public member functions:
+//
+//   void putc(char c);
+//   void putn(const char* s, size_t n);
+//
+// Built-in sources and sinks are dispatched statically; user-defined ones are
+// called through these function pointers, so they may be defined anywhere. The
+// referenced object must outlive the reference.
+struct Source_Ref
+  {
+    void* obj;
+    int (*fn_getc)(void* obj);
+    size_t (*fn_getn)(void* obj, char* s, size_t n);
+    int64_t (*fn_tell)(const void* obj);
+
+    template<typename xSource,
+             ::std::enable_if_t<!::std::is_same<::std::decay_t<xSource>, Source_Ref>::value, int> = 0>
+    explicit
+    Source_Ref(xSource& src)
+      noexcept
+      : obj(::std::addressof(src)),
+        fn_getc([](void* p) -> int { return static_cast<xSource*>(p)->getc();  }),
+        fn_getn([](void* p, char* s, size_t n) -> size_t { return static_cast<xSource*>(p)->getn(s, n);  }),
+        fn_tell([](const void* p) -> int64_t { return static_cast<const xSource*>(p)->tell();  })
+      { }
+  };
+
+struct Sink_Ref
+  {
+    void* obj;
+    void (*fn_putc)(void* obj, char c);
+    void (*fn_putn)(void* obj, const char* s, size_t n);
+
+    template<typename xSink,
+             ::std::enable_if_t<!::std::is_same<::std::decay_t<xSink>, Sink_Ref>::value, int> = 0>
+    explicit
+    Sink_Ref(xSink& sink)
+      noexcept
+      : obj(::std::addressof(sink)),
+        fn_putc([](void* p, char c) { static_cast<xSink*>(p)->putc(c);  }),
+        fn_putn([](void* p, const char* s, size_t n) { static_cast<xSink*>(p)->putn(s, n);  })
+      { }
+  };
+
+// This structure allows a function to be called for each value that is parsed
+// from a stream. The callback is an object of any class which can be called with
+// a `Value&` argument, and it may move the value away.
+struct Callback_Ref
+  {
+    void* obj;
+    void (*fn_call)(void* obj, Value& value);
+
+    template<typename xCallback,
+             ::std::enable_if_t<!::std::is_same<::std::decay_t<xCallback>, Callback_Ref>::value, int> = 0>
+    explicit
+    Callback_Ref(xCallback& callback)
+      noexcept
+      : obj(::std::addressof(callback)),
+        fn_call([](void* p, Value& value) { (*static_cast<xCallback*>(p))(value);  })
+      { }
+  };
+
 // This is the only and comprehensive class that is provided by this library. It is
 // responsible for storing, parsing and formatting all the alternatives above.
 class Value
@@ -710,6 +789,11 @@ class Value
     // configured with `setlocale()`. Errors are stored into `ctx`. The context
     // object does not have to be initialized. If this function stores an error or
     // or throws an exception, the current value is indeterminate.
+    //
+    // Seekable files and file descriptors are read in large blocks, and bytes
+    // that follow the value are returned to the file afterwards. File descriptors
+    // that are not seekable (such as pipes) are also read in blocks, so bytes that
+    // follow the value may be lost.
     void
     parse_with(Parser_Context& ctx, ::asteria::tinyfmt& fmt, Options opts = options_default);
 
@@ -728,6 +812,12 @@ class Value
     void
     parse_with(Parser_Context& ctx, ::std::FILE* fp, Options opts = options_default);
 
+    void
+    parse_with(Parser_Context& ctx, int fd, Options opts = options_default);
+
+    void
+    parse_with(Parser_Context& ctx, const Source_Ref& src, Options opts = options_default);
+
     bool
     parse(::asteria::tinyfmt& fmt, Options opts = options_default);
 
@@ -746,6 +836,56 @@ class Value
     bool
     parse(::std::FILE* fp, Options opts = options_default);
 
+    bool
+    parse(int fd, Options opts = options_default);
+
+    bool
+    parse(const Source_Ref& src, Options opts = options_default);
+
+    // Parse a value, but only build parts that are selected by `paths`, such as
+    // `/meta/id` or `/items/*/price`. Each segment of a path matches a key of an
+    // object, or an index of an array, or anything if it is an asterisk. Members
+    // of objects that are not selected are omitted, and elements of arrays that
+    // are not selected are null. Values that are not selected are skipped as fast
+    // as possible: brackets and braces are matched by type, but strings are
+    // neither decoded nor validated.
+    void
+    parse_with(Parser_Context& ctx, const char* str, size_t len, const ::std::vector<V_string>& paths,
+               Options opts = options_default);
+
+    void
+    parse_with(Parser_Context& ctx, const ::asteria::cow_string& str, const ::std::vector<V_string>& paths,
+               Options opts = options_default);
+
+    bool
+    parse(const char* str, size_t len, const ::std::vector<V_string>& paths, Options opts = options_default);
+
+    bool
+    parse(const ::asteria::cow_string& str, const ::std::vector<V_string>& paths,
+          Options opts = options_default);
+
+    // Parse a value from memory with multiple threads. If the input is a large
+    // array, it is split into chunks at commas between elements, which are parsed
+    // in parallel, and then joined in order. Otherwise, it is parsed as usual.
+    // If `nthreads` is zero, the number of hardware threads is used. The result,
+    // including any error, is the same as parsing sequentially.
+    void
+    parse_parallel_with(Parser_Context& ctx, const char* str, size_t len, unsigned nthreads = 0,
+                        Options opts = options_default);
+
+    bool
+    parse_parallel(const char* str, size_t len, unsigned nthreads = 0, Options opts = options_default);
+
+    // Parse a file for a value. A regular file is mapped into memory and parsed as
+    // a whole, without being copied; other files are read in blocks. If the file
+    // cannot be opened, an error is stored into `ctx`, and `errno` indicates the
+    // cause. The file must not be truncated during the call.
+    void
+    parse_file_with(Parser_Context& ctx, const char* path, Options opts = options_default);
+
+    bool
+    parse_file(const char* path, Options opts = options_default);
+
     // Print this value. Invalid values are sanitized so they may become garbage or
     // null, but the entire output will always be valid TAXON. This function should
     // not throw exceptions on invalid inputs; only in case of an I/O error or
@@ -770,6 +910,10 @@ class Value
     print_to(::std::FILE* fp, Options opts = options_default)
       const;
 
+    void
+    print_to(const Sink_Ref& sink, Options opts = options_default)
+      const;
+
     ::asteria::cow_string
     to_string(Options opts = options_default)
       const;
@@ -777,6 +921,12 @@ class Value
     void
     print_to_stderr(Options opts = options_default)
       const;
+
+    // Release unused capacity of all arrays and objects in this value. Arrays and
+    // objects that are shared with other values are left alone, as they would be
+    // copied otherwise. This function is not recursive.
+    void
+    shrink_to_fit();
   };
 
 inline
@@ -795,6 +945,493 @@ operator<<(::asteria::tinyfmt& fmt, const Value& value)
     return fmt;
   }
 
+// This class holds keys of objects, so they can be shared by values that are
+// parsed separately, such as records with the same schema. Keys are added when
+// they are seen for the first time, until there are `max_size` keys. If it's
+// `thread_safe`, a dictionary may be shared by parsers on multiple threads; a
+// lookup takes a shared lock, and only an addition takes an exclusive lock.
+class Key_Dictionary
+  {
+  private:
+    struct xStorage;
+    ::std::unique_ptr<xStorage> m_stor;
+    size_t m_max_size;
+    bool m_thread_safe;
+
+  public:
+    explicit
+    Key_Dictionary(size_t max_size = 4096, bool thread_safe = true);
+
+    Key_Dictionary(const Key_Dictionary&) = delete;
+    Key_Dictionary& operator=(const Key_Dictionary&) = delete;
+    ~Key_Dictionary();
+
+    size_t
+    max_size()
+      const noexcept
+      { return this->m_max_size;  }
+
+    bool
+    thread_safe()
+      const noexcept
+      { return this->m_thread_safe;  }
+
+    // Gets the number of keys.
+    size_t
+    size()
+      const;
+
+    // Gets a key. If it doesn't exist, it is added, unless the dictionary is full,
+    // in which case a new string is returned.
+    ::asteria::phcow_string
+    intern(const char* str, size_t len);
+
+    // Removes all keys. Keys that are still referenced by values are not freed.
+    void
+    clear();
+  };
+
+// This class parses values like `Value::parse()`, but it keeps its buffers and
+// interned keys between calls. After the first few values, parsing a small value
+// makes few allocations other than those of the value itself. A parser must not
+// be used by multiple threads at the same time.
+class Parser
+  {
+  private:
+    struct xWorkspace;
+    ::std::unique_ptr<xWorkspace> m_work;
+
+  public:
+    // Creates a parser. If `dict` is not null, keys are taken from it, and new
+    // keys are added to it. The dictionary must outlive this parser.
+    explicit
+    Parser(Key_Dictionary* dict = nullptr);
+
+    Parser(const Parser&) = delete;
+    Parser& operator=(const Parser&) = delete;
+    ~Parser();
+
+    // Parse a value into `root`. This is the same as `root.parse_with()`.
+    void
+    parse_with(Value& root, Parser_Context& ctx, ::asteria::tinyfmt& fmt, Options opts = options_default);
+
+    void
+    parse_with(Value& root, Parser_Context& ctx, const ::asteria::cow_string& str,
+               Options opts = options_default);
+
+    void
+    parse_with(Value& root, Parser_Context& ctx, const ::asteria::linear_buffer& ln,
+               Options opts = options_default);
+
+    void
+    parse_with(Value& root, Parser_Context& ctx, const char* str, size_t len, Options opts = options_default);
+
+    void
+    parse_with(Value& root, Parser_Context& ctx, const char* str, Options opts = options_default);
+
+    void
+    parse_with(Value& root, Parser_Context& ctx, const Source_Ref& src, Options opts = options_default);
+
+    bool
+    parse(Value& root, ::asteria::tinyfmt& fmt, Options opts = options_default);
+
+    bool
+    parse(Value& root, const ::asteria::cow_string& str, Options opts = options_default);
+
+    bool
+    parse(Value& root, const ::asteria::linear_buffer& ln, Options opts = options_default);
+
+    bool
+    parse(Value& root, const char* str, size_t len, Options opts = options_default);
+
+    bool
+    parse(Value& root, const char* str, Options opts = options_default);
+
+    bool
+    parse(Value& root, const Source_Ref& src, Options opts = options_default);
+
+    // Releases all buffers and interned keys.
+    void
+    clear()
+      noexcept;
+  };
+
+// Destroy a value on a background thread, which is started on demand. If the
+// value is a large tree, this moves the cost of freeing it away from the calling
+// thread. Values that are neither arrays nor objects, or are shared, are destroyed
+// immediately. After this function returns, `value` is null.
+void
+defer_destroy(Value&& value);
+
+// Wait for all deferred values to be destroyed, then stop the background thread.
+// It will be started again when another value is deferred.
+void
+flush_deferred();
+
+// These are statistics about deferred destruction.
+struct Reclaimer_Stats
+  {
+    size_t queue_depth;         // values that have not been destroyed
+    uint64_t reclaimed_values;  // values that have been destroyed
+    uint64_t reclaimed_nodes;   // all values in them, including themselves
+  };
+
+Reclaimer_Stats
+get_reclaimer_stats();
+
+// This class parses a value from chunks of input which arrive separately, such as
+// from a non-blocking socket. The stack of open arrays and objects, and bytes of a
+// token that has not been completed, are kept between calls to `feed()`, so the
+// entire document need not be buffered.
+class Push_Parser
+  {
+  private:
+    struct xFrame
+      {
+        Value* target;
+        V_array* psa;
+        V_object* pso;
+      };
+
+    Options m_opts;
+    uint32_t m_state;
+    bool m_escaped;
+    Parser_Context m_ctx;
+    int64_t m_offset;
+    ::asteria::cow_string m_pending;
+    ::std::vector<xFrame> m_stack;
+    Value* m_pstor;
+    Value m_root;
+
+    size_t
+    do_run(const char* data, size_t size, bool at_eof);
+
+  public:
+    explicit
+    Push_Parser(Options opts = options_default)
+      {
+        this->reset(opts);
+      }
+
+    Push_Parser(const Push_Parser&) = delete;
+    Push_Parser& operator=(const Push_Parser&) = delete;
+
+    // Discards all states, and prepares for a new value.
+    void
+    reset(Options opts = options_default);
+
+    // Parses a chunk of input. The return value is the number of bytes that have
+    // been consumed. It is less than `size` only if the value has been completed
+    // or an error has occurred; the remaining bytes belong to whatever follows.
+    size_t
+    feed(const char* data, size_t size);
+
+    // Signals the end of input. A number or identifier at the end of input is now
+    // complete. If the value is still incomplete, an error is stored.
+    void
+    finish();
+
+    // Has the value been completed?
+    bool
+    done()
+      const noexcept;
+
+    // Gets the parser context. If an error has occurred, it is stored in here.
+    const Parser_Context&
+    context()
+      const noexcept
+      { return this->m_ctx;  }
+
+    // Gets the value. If the value has not been completed, the result is partial.
+    const Value&
+    value()
+      const noexcept
+      { return this->m_root;  }
+
+    Value&
+    mut_value()
+      noexcept
+      { return this->m_root;  }
+  };
+
+// Parse a stream of values, such as TAXON lines. Values may be separated by
+// whitespace, which is only necessary between two numbers or identifiers. Each
+// value is passed to `callback` once it has been completed. Buffers and interned
+// keys are reused for all values, so this is much faster than parsing them one
+// by one. If an error occurs, it is stored into `ctx`, and parsing stops.
+void
+parse_stream_with(Parser_Context& ctx, const Callback_Ref& callback, const char* str, size_t len,
+                  Options opts = options_default);
+
+void
+parse_stream_with(Parser_Context& ctx, const Callback_Ref& callback, ::std::FILE* fp,
+                  Options opts = options_default);
+
+void
+parse_stream_with(Parser_Context& ctx, const Callback_Ref& callback, int fd,
+                  Options opts = options_default);
+
+void
+parse_stream_with(Parser_Context& ctx, const Callback_Ref& callback, const Source_Ref& src,
+                  Options opts = options_default);
+
+// Parse a stream of values, and append them to `values`. If an error occurs,
+// values before it are still appended.
+bool
+parse_stream(V_array& values, const char* str, size_t len, Options opts = options_default);
+
+bool
+parse_stream(V_array& values, ::std::FILE* fp, Options opts = options_default);
+
+bool
+parse_stream(V_array& values, int fd, Options opts = options_default);
+
+bool
+parse_stream(V_array& values, const Source_Ref& src, Options opts = options_default);
+
+// Parse independent documents with multiple threads. For each document, a value
+// and a context are stored into `values` and `contexts` at the same index, which
+// are resized to the number of documents. Errors don't stop other documents. If
+// `nthreads` is zero, the number of hardware threads is used. Returns `true` if
+// all documents have been parsed successfully. If `dict` is not null, all threads
+// take keys from it; unless `nthreads` is one, it must be thread-safe, otherwise
+// an exception is thrown.
+bool
+parse_batch(V_array& values, ::std::vector<Parser_Context>& contexts, const ::asteria::cow_string* docs,
+            size_t count, unsigned nthreads = 0, Options opts = options_default,
+            Key_Dictionary* dict = nullptr);
+
+// Parse TAXON lines as independent documents with multiple threads. Each line
+// that is not blank is a document. Offsets in `contexts` are relative to `str`.
+bool
+parse_batch(V_array& values, ::std::vector<Parser_Context>& contexts, const char* str, size_t len,
+            unsigned nthreads = 0, Options opts = options_default, Key_Dictionary* dict = nullptr);
+
+// This is the interface of event handlers for `parse_events()`. Instead of building
+// a tree of values, the parser calls these functions as tokens are parsed, so the
+// handler may decide what to keep. Strings and binary data are only valid during
+// calls. The default implementations do nothing.
+class Event_Handler
+  {
+  public:
+    virtual
+    ~Event_Handler();
+
+    virtual
+    void
+    on_start_array();
+
+    virtual
+    void
+    on_end_array();
+
+    virtual
+    void
+    on_start_object();
+
+    virtual
+    void
+    on_end_object();
+
+    virtual
+    void
+    on_key(const char* str, size_t len);
+
+    virtual
+    void
+    on_null();
+
+    virtual
+    void
+    on_boolean(bool value);
+
+    virtual
+    void
+    on_integer(int64_t value);
+
+    virtual
+    void
+    on_number(double value);
+
+    virtual
+    void
+    on_string(const char* str, size_t len);
+
+    virtual
+    void
+    on_binary(const unsigned char* data, size_t size);
+
+    virtual
+    void
+    on_time(V_time value);
+  };
+
+// Parse a value, and pass its contents to `handler` without building a tree of
+// values. No memory is allocated for each token. Duplicate keys in objects are
+// not diagnosed. If an error occurs, it is stored into `ctx`, and parsing stops.
+void
+parse_events_with(Parser_Context& ctx, Event_Handler& handler, const char* str, size_t len,
+                  Options opts = options_default);
+
+void
+parse_events_with(Parser_Context& ctx, Event_Handler& handler, ::std::FILE* fp,
+                  Options opts = options_default);
+
+void
+parse_events_with(Parser_Context& ctx, Event_Handler& handler, int fd,
+                  Options opts = options_default);
+
+void
+parse_events_with(Parser_Context& ctx, Event_Handler& handler, const Source_Ref& src,
+                  Options opts = options_default);
+
+bool
+parse_events(Event_Handler& handler, const char* str, size_t len, Options opts = options_default);
+
+bool
+parse_events(Event_Handler& handler, ::std::FILE* fp, Options opts = options_default);
+
+bool
+parse_events(Event_Handler& handler, int fd, Options opts = options_default);
+
+bool
+parse_events(Event_Handler& handler, const Source_Ref& src, Options opts = options_default);
+
+// Check whether a value is valid, without building it. All checks that are done
+// by `Value::parse()` are done, including those about annotated strings and
+// duplicate keys. If the value is invalid, an error is stored into `ctx`.
+void
+validate_with(Parser_Context& ctx, const char* str, size_t len, Options opts = options_default);
+
+bool
+validate(const char* str, size_t len, Options opts = options_default);
+
+// This class refers to a value in a `Document`. Nothing is decoded until it is
+// requested. A `Lazy_Value` is valid as long as its document is neither modified
+// nor moved.
+class Lazy_Value
+  {
+  private:
+    friend class Document;
+
+    const Document* m_doc;
+    uint32_t m_index;
+
+    constexpr
+    Lazy_Value(const Document* doc, uint32_t index)
+      noexcept
+      : m_doc(doc), m_index(index)  { }
+
+  public:
+    // Creates a reference to no value, which is null.
+    constexpr
+    Lazy_Value()
+      noexcept
+      : m_doc(), m_index()  { }
+
+    // Gets the type of the value. Annotated strings are classified by annotators,
+    // but their payloads are only validated when decoded.
+    Type
+    type()
+      const noexcept;
+
+    // Gets the number of elements of an array, or members of an object. For all
+    // other types, zero is returned.
+    size_t
+    size()
+      const noexcept;
+
+    // Gets an element of an array, or the value of a member of an object, in the
+    // order in which they appear in the source. If `index` is out of range, an
+    // exception is thrown.
+    Lazy_Value
+    at(size_t index)
+      const;
+
+    // Gets the key of a member of an object. If `index` is out of range, an
+    // exception is thrown.
+    V_string
+    key_at(size_t index)
+      const;
+
+    // Searches an object for a member. If a member is found, its value is stored
+    // into `value` and `true` is returned; otherwise `false` is returned.
+    bool
+    find(const char* key, size_t len, Lazy_Value& value)
+      const;
+
+    // Gets the source text of the value, which may be forwarded without being
+    // decoded.
+    const char*
+    raw_data()
+      const noexcept;
+
+    size_t
+    raw_size()
+      const noexcept;
+
+    // Decodes the value. Arrays and objects are decoded recursively. If the value
+    // is invalid, such as a malformed annotated string or a duplicate key, an
+    // exception is thrown.
+    Value
+    to_value()
+      const;
+  };
+
+// This class parses a value into a tape, which is an array of offsets and types
+// of tokens. Strings, binary data and nested arrays and objects are decoded when
+// they are accessed through `root()`. For large values of which only some parts
+// are used, this is much faster than building a tree of values.
+class Document
+  {
+  private:
+    friend class Lazy_Value;
+
+    struct xEntry
+      {
+        uint32_t offset;  // offset of the first byte of the value
+        uint32_t end;     // offset past the last byte of the value
+        uint32_t next;    // index of the next value, after all descendants
+        uint32_t size;    // number of elements or members
+        Type type;
+      };
+
+    ::asteria::cow_string m_str;
+    const char* m_bptr;
+    Options m_opts;
+    ::std::vector<xEntry> m_tape;
+
+    void
+    do_build_tape(Parser_Context& ctx, size_t len);
+
+  public:
+    Document()
+      noexcept
+      : m_bptr(), m_opts()  { }
+
+    // Parse a value. The syntax is checked, but annotated strings are not decoded
+    // yet, and duplicate keys are not diagnosed. If a buffer is passed, it must
+    // outlive this document; a string is shared, instead of being copied. The input
+    // must not exceed 4 GiB.
+    void
+    parse_with(Parser_Context& ctx, const char* str, size_t len, Options opts = options_default);
+
+    void
+    parse_with(Parser_Context& ctx, const ::asteria::cow_string& str, Options opts = options_default);
+
+    bool
+    parse(const char* str, size_t len, Options opts = options_default);
+
+    bool
+    parse(const ::asteria::cow_string& str, Options opts = options_default);
+
+    // Gets the root value. If no value has been parsed, it is null.
+    Lazy_Value
+    root()
+      const noexcept
+      { return Lazy_Value(this->m_tape.empty() ? nullptr : this, 0);  }
+  };
+
 // These are static objects that need not be destroyed.
 extern const char null_storage[];
 static const Value& null = reinterpret_cast<const Value&>(null_storage);
@@ -3,13 +3,18 @@
 
 #include "taxon.hpp"
 #include <new>
+#include <atomic>
 #include <climits>
+#include <cfloat>
 #include <cmath>
 #include <cstdlib>
+#include <unistd.h>
+#include <fcntl.h>
 #undef NDEBUG
 #include <assert.h>
 
-::std::size_t alloc_count;
+::std::atomic<::std::size_t> alloc_count;
+::std::atomic<::std::size_t> new_count;
 
 void*
 operator new(::std::size_t size)
@@ -19,6 +24,7 @@ operator new(::std::size_t size)
       ::std::abort();
 
     ::alloc_count ++;
+    ::new_count ++;
     return ptr;
   }
 
@@ -429,6 +435,1004 @@ main(void)
       assert(ctx.error == nullptr);
     }
 
+    {
+      // structural index across blocks
+      ::asteria::cow_string str;
+      str.append("\xEF\xBB\xBF[", 4);
+      for(::std::size_t k = 0;  k != 50;  ++k) {
+        str.append(k, ' ');
+        str.append(R"("a\"b\\",{"x":true},")", 21);
+        str.append(k % 7 * 2, '\\');
+        str.append(R"(", -12.5e1,)", 11);
+      }
+      str.append("null]", 5);
+
+      ::taxon::Value val;
+      assert(val.parse(str));
+      assert(val.as_array_size() == 201);
+      assert(val.as_array().at(0).as_string() == "a\"b\\");
+      assert(val.as_array().at(1).as_object().at(&"x").as_boolean() == true);
+      assert(val.as_array().at(194).as_string() == "\\\\\\\\\\\\");
+      assert(val.as_array().at(199).as_number() == -125);
+      assert(val.as_array().at(200).is_null());
+
+      ::taxon::Parser_Context ctx;
+      val.parse_with(ctx, &R"([1}])");
+      assert(ctx.offset == 2);
+      assert(::std::strcmp(ctx.error, "Missing comma or closed bracket") == 0);
+
+      val.parse_with(ctx, &R"([truex])");
+      assert(ctx.offset == 1);
+      assert(::std::strcmp(ctx.error, "Invalid token") == 0);
+
+      val.parse_with(ctx, &R"([1.e5])");
+      assert(ctx.offset == 1);
+      assert(::std::strcmp(ctx.error, "Invalid number") == 0);
+
+      // An invalid UTF-8 sequence after an identifier swallows the comma.
+      val.parse_with(ctx, "[null\xEF,\xBF\"a\"]", 12);
+      assert(ctx.offset == 8);
+      assert(::std::strcmp(ctx.error, "Missing comma or closed bracket") == 0);
+    }
+
+    {
+      // long hex strings
+      static constexpr char source[] =
+          R"(["$h:00112233445566778899AABBCCDDEEFFaabbccddeeff0f1e2d3c4b5a69788796a5b4c3d2e1f0",)"
+          R"("$h:00112233445566778899aabbccddeeff00112233445566778899aabbccddeeff0g",)"
+          R"("$h:00112233445566778899aabbccddeeff0:112233445566778899aabbccddeeff00"])";
+      static constexpr unsigned char bytes[] =
+          "\x00\x11\x22\x33\x44\x55\x66\x77\x88\x99\xAA\xBB\xCC\xDD\xEE\xFF"
+          "\xaa\xbb\xcc\xdd\xee\xff\x0f\x1e\x2d\x3c\x4b\x5a\x69\x78\x87\x96"
+          "\xa5\xb4\xc3\xd2\xe1\xf0";
+
+      ::taxon::Value val;
+      ::taxon::Parser_Context ctx;
+      val.parse_with(ctx, &source);
+      assert(ctx.offset == 83);
+      assert(::std::strcmp(ctx.error, "Invalid hexadecimal digit") == 0);
+
+      ::asteria::cow_string str(source, 82);
+      str.push_back(']');
+      val.parse_with(ctx, str);
+      assert(ctx.error == nullptr);
+      assert(val.as_array().at(0).as_binary_size() == 38);
+      assert(::std::memcmp(val.as_array().at(0).as_binary_data(), bytes, 38) == 0);
+
+      str.assign(source + 155, 71);
+      val.parse_with(ctx, str);
+      assert(ctx.offset == 0);
+      assert(::std::strcmp(ctx.error, "Invalid hexadecimal digit") == 0);
+    }
+
+    {
+      // long base64 strings
+      ::asteria::cow_string str = &R"("$b:AAECAwQFBgcICQoLDA0ODxAREhMUFRYXGBkaGxwdHh8gISIjJCUmJygpKissLS4vMDEyMzQ1Njc4OTo7PD0+P0BBQkNERUZHSElKS0xNTk9QUVJTVFVWV1hZWltcXV5fYGFiYw==")";
+      ::taxon::Value val;
+      assert(val.parse(str));
+      assert(val.as_binary_size() == 100);
+      for(::std::size_t k = 0;  k != 100;  ++k)
+        assert(val.as_binary_data()[k] == k);
+      assert(val.to_string() == str);
+
+      ::taxon::Parser_Context ctx;
+      val.parse_with(ctx, &R"("$b:AAECAwQFBgcICQoLDA0ODxAREhMUFRYXGBkaGxwdHh8gISIjJC*mJygpKissLS4vMDEyMzQ1Njc4OTo7PD0+P0BBQkNERUZHSElKS0xNTk9QUVJTVFVWV1hZWltcXV5fYGFiYw==")");
+      assert(ctx.offset == 0);
+      assert(::std::strcmp(ctx.error, "Invalid base64 digit") == 0);
+
+      assert(val.parse(&R"("$b:QQ==QUJDQUJDQUJDQUJDQUJDQUJDQUJDQUJDQUJDQUJDQUJD")"));
+      assert(val.as_binary_size() == 34);
+      assert(::std::memcmp(val.as_binary_data(), "AABCABCABCABCABCABCABCABCABCABCABC", 34) == 0);
+    }
+
+    {
+      // binary encoding across blocks
+      static constexpr char b64_digits[] =
+          "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+      ::asteria::cow_bstring bin;
+      ::asteria::cow_string str;
+      ::taxon::Value val;
+      for(::std::size_t n = 0;  n < 1600;  n += 1 + n / 64) {
+        bin.clear();
+        for(::std::size_t k = 0;  k != n;  ++k)
+          bin.push_back(static_cast<unsigned char>(k * 131 + n));
+
+        str = &"\"$b:";
+        for(::std::size_t k = 0;  k < n;  k += 3) {
+          ::std::uint32_t word = static_cast<::std::uint32_t>(bin[k]) << 16;
+          if(k + 1 < n)
+            word |= static_cast<::std::uint32_t>(bin[k+1]) << 8;
+          if(k + 2 < n)
+            word |= bin[k+2];
+          str.push_back(b64_digits[word >> 18]);
+          str.push_back(b64_digits[word >> 12 & 63]);
+          str.push_back((k + 1 < n) ? b64_digits[word >> 6 & 63] : '=');
+          str.push_back((k + 2 < n) ? b64_digits[word & 63] : '=');
+        }
+        str.push_back('\"');
+
+        val = bin;
+        assert(val.to_string(::taxon::option_bin_as_base64) == str);
+        assert(val.parse(str));
+        assert(val.as_binary() == bin);
+      }
+
+      static constexpr char hex_digits[] = "0123456789abcdef";
+      bin.clear();
+      str = &"\"$h:";
+      for(::std::size_t k = 0;  k != 32;  ++k) {
+        bin.push_back(static_cast<unsigned char>(k * 0x11 + 0x0F));
+        str.push_back(hex_digits[bin[k] >> 4]);
+        str.push_back(hex_digits[bin[k] & 15]);
+      }
+      str.push_back('\"');
+
+      val = bin;
+      assert(val.to_string() == str);
+    }
+
+    {
+      // tokens that refer to the source, and tokens that have to be decoded
+      ::taxon::Value val;
+      assert(val.parse(&R"({"plain":"hello","esc":"a\tbA","mb":"été","":"",
+                            "$s:x":["$s:$s:","$l:-42",1.5e3,null,true,false]})"));
+      assert(val.as_object().size() == 5);
+      assert(val.as_object().at(&"plain").as_string() == "hello");
+      assert(val.as_object().at(&"esc").as_string() == "a\tbA");
+      assert(val.as_object().at(&"mb").as_string() == "\xC3\xA9t\xC3\xA9");
+      assert(val.as_object().at(&"").as_string() == "");
+      const auto& arr = val.as_object().at(&"$s:x").as_array();
+      assert(arr.size() == 6);
+      assert(arr.at(0).as_string() == "$s:");
+      assert(arr.at(1).as_integer() == -42);
+      assert(arr.at(2).as_number() == 1500);
+      assert(arr.at(3).is_null());
+      assert(arr.at(4).as_boolean() == true);
+      assert(arr.at(5).as_boolean() == false);
+
+      assert(val.parse(&" \t12345"));
+      assert(val.as_number() == 12345);
+      assert(val.parse(&"\"$h:0123\""));
+      assert(val.as_binary_size() == 2);
+
+      ::taxon::Parser_Context ctx;
+      val.parse_with(ctx, &"[\"abc");
+      assert(ctx.offset == 1);
+      assert(::std::strcmp(ctx.error, "String not terminated properly") == 0);
+    }
+
+    {
+      // user-defined source and sink
+      struct Chunk_Source
+        {
+          const char* ptr;
+          ::std::size_t len;
+          ::std::size_t off;
+
+          int
+          getc()
+            {
+              if(this->off == this->len)
+                return -1;
+              return static_cast<unsigned char>(this->ptr[this->off++]);
+            }
+
+          ::std::size_t
+          getn(char* s, ::std::size_t n)
+            {
+              n = ::std::min(n, this->len - this->off);
+              ::std::memcpy(s, this->ptr + this->off, n);
+              this->off += n;
+              return n;
+            }
+
+          ::std::int64_t
+          tell()
+            const
+            { return static_cast<::std::int64_t>(this->off);  }
+        };
+
+      struct Counting_Sink
+        {
+          ::asteria::cow_string str;
+          ::std::size_t calls = 0;
+
+          void
+          putc(char c)
+            {
+              this->str.push_back(c);
+              this->calls ++;
+            }
+
+          void
+          putn(const char* s, ::std::size_t n)
+            {
+              this->str.append(s, n);
+              this->calls ++;
+            }
+        };
+
+      static constexpr char text[] = R"([1,"$l:2",{"k":"é"},"$h:0102",null])";
+      Chunk_Source src = { text, sizeof(text) - 1, 0 };
+      ::taxon::Source_Ref src_ref(src);
+      ::taxon::Source_Ref src_copy(src_ref);
+      ::taxon::Value val;
+      assert(val.parse(src_copy));
+      assert(src.off == src.len);
+      assert(val.as_array().size() == 5);
+      assert(val.as_array().at(2).as_object().at(&"k").as_string() == "\xC3\xA9");
+
+      Counting_Sink sink;
+      ::taxon::Sink_Ref sink_ref(sink);
+      ::taxon::Sink_Ref sink_copy(sink_ref);
+      val.print_to(sink_copy);
+      assert(sink.calls != 0);
+      assert(sink.str == val.to_string());
+
+      src = { "[1,}", 4, 0 };
+      ::taxon::Parser_Context ctx;
+      val.parse_with(ctx, ::taxon::Source_Ref(src));
+      assert(ctx.offset == 3);
+      assert(::std::strcmp(ctx.error, "Invalid token") == 0);
+    }
+
+    {
+      // files and file descriptors, read in blocks
+      ::asteria::cow_string str = &"[";
+      for(::std::size_t k = 0;  k != 400;  ++k) {
+        str.append(k % 7, ' ');
+        str += "\"$s:";
+        str.append(k * 3 % 1000, 'a');
+        str += "\\n\\u00E9\xC3\xA9\\uD83D\\uDE00\",";
+        str += "\"$l:";
+        str.append(1, static_cast<char>('1' + k % 9));
+        str += "\",";
+      }
+      str += "-123.5] {\"next\":true}";
+
+      ::taxon::Value val, mval;
+      assert(mval.parse(str));
+      ::asteria::cow_string expected = mval.to_string();
+
+      ::std::FILE* fp = ::std::tmpfile();
+      assert(fp);
+      assert(::std::fwrite(str.data(), 1, str.size(), fp) == str.size());
+      ::std::rewind(fp);
+
+      assert(val.parse(fp));
+      assert(val.to_string() == expected);
+      assert(val.parse(fp));
+      assert(val.as_object().at(&"next").as_boolean() == true);
+      assert(!val.parse(fp));
+
+      ::std::fflush(fp);
+      int fd = ::fileno(fp);
+      assert(::lseek(fd, 0, SEEK_SET) == 0);
+      assert(val.parse(fd));
+      assert(val.to_string() == expected);
+      ::taxon::Parser_Context ctx;
+      val.parse_with(ctx, fd);
+      assert(ctx.error == nullptr);
+      assert(val.as_object().at(&"next").as_boolean() == true);
+      ::std::fclose(fp);
+
+      int pfds[2];
+      assert(::pipe(pfds) == 0);
+      assert(::write(pfds[1], "{\"a\":[1,\"$h:abcd\"]}", 20) == 20);
+      ::close(pfds[1]);
+      val.parse_with(ctx, pfds[0]);
+      assert(ctx.error == nullptr);
+      assert(val.as_object().at(&"a").as_array().at(1).as_binary_size() == 2);
+      ::close(pfds[0]);
+    }
+
+    {
+      // memory-mapped files
+      ::asteria::cow_string str = &"{\"list\":[";
+      for(::std::size_t k = 0;  k != 5000;  ++k)
+        str += "\"$t:1708444618089\",\"$h:0011\",\"item\",";
+      str += "true]}";
+
+      char path[] = "/tmp/taxon_test_XXXXXX";
+      int fd = ::mkstemp(path);
+      assert(fd >= 0);
+      assert(::write(fd, str.data(), str.size()) == static_cast<::ssize_t>(str.size()));
+      ::close(fd);
+
+      ::taxon::Value val;
+      assert(val.parse_file(path));
+      assert(val.as_object().at(&"list").as_array().size() == 15001);
+      assert(val.as_object().at(&"list").as_array().at(15000).as_boolean() == true);
+
+      fd = ::open(path, O_WRONLY | O_TRUNC);
+      assert(fd >= 0);
+      ::close(fd);
+      ::taxon::Parser_Context ctx;
+      val.parse_file_with(ctx, path);
+      assert(::std::strcmp(ctx.error, "Blank input") == 0);
+
+      ::unlink(path);
+      val = true;
+      val.parse_file_with(ctx, path);
+      assert(ctx.offset == 0);
+      assert(::std::strcmp(ctx.error, "Could not open file") == 0);
+      assert(val.is_null());
+    }
+
+    {
+      // push parser
+      static constexpr char text[] =
+          " {\"a\": [1, -2.5e3, \"$h:0011\", \"x\\\"\\u00e9\xe4\xb8\xad\"], \"b\": {\"c\": null},"
+          " \"long\": \"$s:aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa\", \"n\": true }";
+      ::taxon::Value expected;
+      assert(expected.parse(text));
+
+      for(::std::size_t step = 1;  step != 20;  ++step) {
+        ::taxon::Push_Parser push;
+        ::std::size_t off = 0;
+        while(off != sizeof(text) - 1) {
+          ::std::size_t n = ::std::min(step, sizeof(text) - 1 - off);
+          assert(push.feed(text + off, n) == n);
+          off += n;
+        }
+        assert(push.done());
+        assert(push.context().error == nullptr);
+        assert(push.value().to_string() == expected.to_string());
+      }
+
+      // Documents are separated by the parser.
+      ::taxon::Push_Parser push;
+      assert(push.feed("[1,2] [3]", 9) == 5);
+      assert(push.done());
+      assert(push.value().as_array().size() == 2);
+      assert(push.feed(" ", 1) == 0);
+
+      // A number at the end of input is complete only upon `finish()`.
+      push.reset();
+      assert(push.feed("12", 2) == 2);
+      assert(push.feed("34", 2) == 2);
+      assert(!push.done());
+      push.finish();
+      assert(push.done());
+      assert(push.value().as_number() == 1234);
+
+      push.reset();
+      assert(push.feed("[1, 2", 5) == 5);
+      push.finish();
+      assert(!push.done());
+      assert(::std::strcmp(push.context().error, "Array not terminated properly") == 0);
+
+      push.reset();
+      assert(push.feed("{\"a\":1,", 7) == 7);
+      assert(push.feed(" \"a\" :2}", 8) == 1);
+      assert(::std::strcmp(push.context().error, "Duplicate key string") == 0);
+      assert(push.context().offset == 8);
+
+      push.reset();
+      push.finish();
+      assert(::std::strcmp(push.context().error, "Blank input") == 0);
+    }
+
+    {
+      // streams of values
+      ::asteria::cow_string str;
+      for(int k = 0;  k != 100;  ++k)
+        str += "{\"id\":1,\"tags\":[\"$h:00\",null]}\n";
+      str += "[]{}\"s\"1 2\r\n";
+
+      ::taxon::V_array values;
+      assert(::taxon::parse_stream(values, str.data(), str.size()));
+      assert(values.size() == 105);
+      assert(values.at(99).as_object().at(&"tags").as_array().at(0).as_binary_size() == 1);
+      assert(values.at(101).is_object());
+      assert(values.at(103).as_number() == 1);
+      assert(values.at(104).as_number() == 2);
+
+      ::std::FILE* fp = ::std::tmpfile();
+      assert(fp);
+      ::std::fwrite(str.data(), 1, str.size(), fp);
+      ::std::fputs("{\"id\":2,\"id\":3}\n{}", fp);
+      ::std::rewind(fp);
+
+      ::std::size_t count = 0;
+      auto counter = [&](::taxon::Value& value) { count += value.is_object();  };
+      ::taxon::Callback_Ref counter_ref(counter);
+      ::taxon::Callback_Ref counter_copy(counter_ref);
+      ::taxon::Parser_Context ctx;
+      ::taxon::parse_stream_with(ctx, counter_copy, fp);
+      assert(::std::strcmp(ctx.error, "Duplicate key string") == 0);
+      assert(ctx.offset == static_cast<::std::int64_t>(str.size() + 8));
+      assert(count == 101);
+      ::std::fclose(fp);
+
+      values.clear();
+      assert(::taxon::parse_stream(values, " \n", 2));
+      assert(values.empty());
+    }
+
+    {
+      // streams with many unique keys
+      ::std::FILE* fp = ::std::tmpfile();
+      assert(fp);
+      for(int k = 0;  k != 20000;  ++k)
+        ::std::fprintf(fp, "{\"key%d\":%d}\n", k, k);
+      ::std::rewind(fp);
+
+      ::std::size_t base = ::alloc_count;
+      ::std::size_t peak = 0;
+      auto watcher = [&](::taxon::Value&) { peak = ::std::max<::std::size_t>(peak, ::alloc_count);  };
+      ::taxon::Parser_Context ctx;
+      ::taxon::parse_stream_with(ctx, ::taxon::Callback_Ref(watcher), fp);
+      assert(ctx.error == nullptr);
+      assert(peak - base < 10000);
+      ::std::fclose(fp);
+    }
+
+    {
+      // event handlers
+      struct Printer : ::taxon::Event_Handler
+        {
+          ::asteria::cow_string out;
+
+          void on_start_array() override { this->out += "[";  }
+          void on_end_array() override { this->out += "]";  }
+          void on_start_object() override { this->out += "{";  }
+          void on_end_object() override { this->out += "}";  }
+          void on_key(const char* s, ::std::size_t n) override { this->out.append(s, n) += "=";  }
+          void on_null() override { this->out += "N";  }
+          void on_boolean(bool v) override { this->out += v ? "T" : "F";  }
+          void on_integer(::std::int64_t v) override { this->out += (v == -42) ? "L" : "?";  }
+          void on_number(double v) override { this->out += (v == 1.5) ? "D" : "?";  }
+          void on_string(const char* s, ::std::size_t n) override { this->out += "'";  this->out.append(s, n);  }
+          void on_binary(const unsigned char* p, ::std::size_t n) override { this->out += ((n == 2) && (p[1] == 0x42)) ? "B" : "?";  }
+          void on_time(::taxon::V_time v) override { this->out += (v.time_since_epoch().count() != 0) ? "t" : "?";  }
+        };
+
+      static constexpr char text[] =
+          "{\"a\":[1.5,\"$l:-42\",\"x\\ny\",null,true,false,[],{}],\"b\":{\"c\":\"$h:4142\",\"d\":\"$b:QUI=\"},"
+          "\"e\":\"$t:1708444618089\",\"f\":\"$s:$z\"}";
+      Printer printer;
+      assert(::taxon::parse_events(printer, text, sizeof(text) - 1));
+      assert(printer.out == "{a=[DL'x\nyNTF[]{}]b={c=Bd=B}e=tf='$z}");
+
+      printer.out.clear();
+      ::taxon::Parser_Context ctx;
+      static constexpr char json_text[] = "[\"$l:1\"]";
+      ::taxon::parse_events_with(ctx, printer, json_text, sizeof(json_text) - 1, ::taxon::option_json_mode);
+      assert(ctx.error == nullptr);
+      assert(printer.out == "['$l:1]");
+
+      static constexpr char bad_text[] = "[1,{\"a\" 2}]";
+      ::taxon::parse_events_with(ctx, printer, bad_text, sizeof(bad_text) - 1);
+      assert(::std::strcmp(ctx.error, "Missing colon") == 0);
+      assert(ctx.offset == 8);
+
+      // No memory is allocated for each token.
+      ::asteria::cow_string str = &"[";
+      for(int k = 0;  k != 1000;  ++k)
+        str += "{\"key\":\"value\",\"n\":[1,null]},";
+      str += "true]";
+      struct Checker : ::taxon::Event_Handler
+        {
+          ::std::size_t min_count = SIZE_MAX, max_count = 0;
+
+          void on_null() override
+            {
+              this->min_count = ::std::min(this->min_count, ::alloc_count.load());
+              this->max_count = ::std::max(this->max_count, ::alloc_count.load());
+            }
+        };
+
+      Checker checker;
+      assert(::taxon::parse_events(checker, str.data(), str.size()));
+      assert(checker.min_count == checker.max_count);
+    }
+
+    {
+      // lazy documents
+      ::asteria::cow_string str = &"{\"header\":{\"to\":\"node-1\",\"id\":\"$l:42\"},\"b\\u0061d\":\"$h:zz\","
+                                   "\"body\":[1,\"$b:QUI=\",\"$t:1708444618089\",{\"x\":[]}],\"n\":null}";
+      ::taxon::Document doc;
+      assert(doc.parse(str));
+
+      ::taxon::Lazy_Value root = doc.root();
+      assert(root.type() == ::taxon::t_object);
+      assert(root.size() == 4);
+      assert(root.key_at(1) == "bad");
+
+      ::taxon::Lazy_Value header, value;
+      assert(root.find("header", 6, header));
+      assert(header.find("id", 2, value));
+      assert(value.type() == ::taxon::t_integer);
+      assert(value.to_value().as_integer() == 42);
+      assert(header.at(0).to_value().as_string() == "node-1");
+      assert(!header.find("from", 4, value));
+
+      assert(root.find("bad", 3, value));
+      assert(value.type() == ::taxon::t_binary);
+      try {
+        value.to_value();
+        assert(false);
+      }
+      catch(::std::invalid_argument&) { }
+
+      assert(root.find("body", 4, value));
+      assert(::asteria::cow_string(value.raw_data(), value.raw_size())
+             == "[1,\"$b:QUI=\",\"$t:1708444618089\",{\"x\":[]}]");
+      assert(value.size() == 4);
+      assert(value.at(1).to_value().as_binary_size() == 2);
+      assert(value.at(2).type() == ::taxon::t_time);
+      assert(value.at(3).at(0).type() == ::taxon::t_array);
+      assert(value.at(3).to_value().as_object().at(&"x").as_array().empty());
+      assert(root.at(3).type() == ::taxon::t_null);
+      try {
+        value.at(4);
+        assert(false);
+      }
+      catch(::std::out_of_range&) { }
+
+      ::taxon::Parser_Context ctx;
+      doc.parse_with(ctx, "[1, 2", 5);
+      assert(::std::strcmp(ctx.error, "Array not terminated properly") == 0);
+      assert(doc.root().type() == ::taxon::t_null);
+
+      assert(doc.parse(" 1.5 ", 5));
+      assert(doc.root().raw_size() == 3);
+      assert(doc.root().to_value().as_number() == 1.5);
+    }
+
+    {
+      // projection
+      ::asteria::cow_string str = &"{\"meta\":{\"id\":\"$l:7\",\"skip\":\"\\u0041\\\"]}\"},\"junk\":[{\"a\":[[]]},\"}\"],"
+                                   "\"items\":[{\"price\":1,\"name\":\"x\"},{\"name\":\"y\"},{\"price\":{\"v\":3}}],\"x\":2}";
+      ::taxon::Value val;
+      assert(val.parse(str, { &"/meta/id", &"/items/*/price", &"/nothing" }));
+      assert(val.to_string() == "{\"meta\":{\"id\":\"$l:7\"},\"items\":[{\"price\":1},{},{\"price\":{\"v\":3}}]}");
+
+      assert(val.parse(str, { &"/items/1", &"/meta" }));
+      assert(val.to_string() == "{\"meta\":{\"id\":\"$l:7\",\"skip\":\"A\\\"]}\"},\"items\":[null,{\"name\":\"y\"},null]}");
+
+      assert(val.parse(str, { &"" }));
+      ::taxon::Value full;
+      assert(full.parse(str));
+      assert(val.to_string() == full.to_string());
+
+      ::taxon::Parser_Context ctx;
+      val.parse_with(ctx, "{\"a\":1,\"b\":[1,[", 16, { &"/a" });
+      assert(::std::strcmp(ctx.error, "Array not terminated properly") == 0);
+      val.parse_with(ctx, "{\"a\":1,\"b\":[1,{]}}", 18, { &"/a" });
+      assert(::std::strcmp(ctx.error, "Object not terminated properly") == 0);
+      assert(ctx.offset == 15);
+      val.parse_with(ctx, "{\"a\":1,\"b\":[1,{\"x\":[1]]}", 24, { &"/a" });
+      assert(::std::strcmp(ctx.error, "Object not terminated properly") == 0);
+      assert(ctx.offset == 22);
+
+      // Types of deeply nested arrays and objects are kept.
+      ::asteria::cow_string deep = &"{\"a\":1,\"b\":";
+      for(int k = 0;  k != 150;  ++k)
+        deep += (k % 3 == 0) ? "{\"x\":" : "[";
+      deep += "null";
+      for(int k = 150;  k != 0;  --k)
+        deep += ((k - 1) % 3 == 0) ? "}" : "]";
+      deep += "}";
+      assert(val.parse(deep, { &"/a" }));
+      deep.erase(deep.size() - 3, 1);
+      val.parse_with(ctx, deep, { &"/a" });
+      assert(::std::strcmp(ctx.error, "Array not terminated properly") == 0);
+      assert(ctx.offset == static_cast<::std::int64_t>(deep.size() - 2));
+      val.parse_with(ctx, "{\"a\":1,\"b\":tru}", 15, { &"/a" });
+      assert(::std::strcmp(ctx.error, "Invalid token") == 0);
+      assert(ctx.offset == 11);
+    }
+
+    {
+      // validation
+      static constexpr char good[] = "{\"a\":[1,\"$l:-9\",\"$t:0\",\"$h:00ff\",\"$b:AAE=\"],\"b\\u0000\":{\"a\":null}}";
+      assert(::taxon::validate(good, sizeof(good) - 1));
+
+      ::taxon::Parser_Context ctx;
+      ::taxon::validate_with(ctx, "{\"a\":1,\"\\u0061\":2}", 18);
+      assert(::std::strcmp(ctx.error, "Duplicate key string") == 0);
+      assert(ctx.offset == 7);
+      ::taxon::validate_with(ctx, "[\"$t:9999999999999999\"]", 23);
+      assert(::std::strcmp(ctx.error, "Timestamp value out of range") == 0);
+      ::taxon::validate_with(ctx, "[\"$h:0\"]", 8);
+      assert(::std::strcmp(ctx.error, "Invalid hex string") == 0);
+      ::taxon::validate_with(ctx, "\"\xC0\x80\"", 4);
+      assert(::std::strcmp(ctx.error, "Invalid Unicode character") == 0);
+
+      // Large objects are checked with hash tables.
+      ::asteria::cow_string str = &"{";
+      for(int k = 0;  k != 1000;  ++k) {
+        str += "\"b";
+        str += ::std::to_string(k).c_str();
+        str += "\":{\"x\":1,\"x2\":[]},";
+      }
+      str += "\"z\":0}";
+      assert(::taxon::validate(str.data(), str.size()));
+      str.pop_back();
+      str += ",\"b1\":2}";
+      ::taxon::validate_with(ctx, str.data(), str.size());
+      assert(::std::strcmp(ctx.error, "Duplicate key string") == 0);
+      assert(ctx.offset == static_cast<::std::int64_t>(str.size() - 7));
+    }
+
+    {
+      // parallel parsing
+      ::asteria::cow_string str = &"[";
+      for(int k = 0;  k != 20000;  ++k) {
+        str += "{\"id\":";
+        str += ::std::to_string(k).c_str();
+        str += ",\"name\":\"a, [b] {c}\",\"tags\":[\"$l:-1\",\"$h:00ff\",true,null]},";
+      }
+      str += "\"end\"]";
+      assert(str.size() > 1048576);
+
+      ::taxon::Value seq, par;
+      ::taxon::Parser_Context ctx, pctx;
+      seq.parse_with(ctx, str.data(), str.size());
+      assert(!ctx.error);
+      par.parse_parallel_with(pctx, str.data(), str.size(), 4);
+      assert(!pctx.error);
+      assert(pctx.offset == ctx.offset);
+      assert(par.as_array().size() == 20001);
+      assert(par.to_string() == seq.to_string());
+      assert(par.parse_parallel(str.data(), str.size(), 1));
+      assert(par.to_string() == seq.to_string());
+
+      // An error in a late chunk is reported as if parsed sequentially.
+      str.mut_data()[str.size() - 100] = '#';
+      seq.parse_with(ctx, str.data(), str.size());
+      assert(ctx.error);
+      par.parse_parallel_with(pctx, str.data(), str.size(), 4);
+      assert(pctx.error == ctx.error);
+      assert(pctx.offset == ctx.offset);
+    }
+
+    {
+      // batch parsing
+      ::asteria::cow_string lines;
+      for(int k = 0;  k != 5000;  ++k) {
+        lines += "{\"id\":";
+        lines += ::std::to_string(k).c_str();
+        lines += ",\"v\":[\"$l:-1\",true]}\r\n";
+        if(k % 1000 == 0)
+          lines += "  \n";
+      }
+      lines += "[1,2\n\"end\"";
+
+      ::taxon::V_array values;
+      ::std::vector<::taxon::Parser_Context> contexts;
+      assert(!::taxon::parse_batch(values, contexts, lines.data(), lines.size(), 4));
+      assert(values.size() == 5002);
+      assert(contexts.size() == 5002);
+      for(int k = 0;  k != 5000;  ++k) {
+        assert(!contexts.at(static_cast<size_t>(k)).error);
+        assert(values.at(static_cast<size_t>(k)).as_object().at(&"id").as_number() == k);
+      }
+      assert(::std::strcmp(contexts.at(5000).error, "Array not terminated properly") == 0);
+      assert(contexts.at(5000).offset == static_cast<::std::int64_t>(lines.size() - 6));
+      assert(values.at(5001).as_string() == "end");
+
+      ::asteria::cow_string docs[3] = { &"1", &"{\"a\":", &"\"$h:00\"" };
+      assert(!::taxon::parse_batch(values, contexts, docs, 3, 2));
+      assert(values.size() == 3);
+      assert(values.at(0).as_number() == 1);
+      assert(::std::strcmp(contexts.at(1).error, "Missing value") == 0);
+      assert(values.at(2).as_binary().size() == 1);
+      assert(::taxon::parse_batch(values, contexts, docs + 2, 1, 1));
+    }
+
+    {
+      // deferred destruction
+      ::taxon::Value val;
+      auto pval = &val;
+      for(int k = 0;  k != 1000;  ++k) {
+        auto& arr = pval->open_array();
+        arr.emplace_back(k);
+        arr.emplace_back(&"hello");
+        pval = &(arr.emplace_back());
+      }
+
+      auto stats = ::taxon::get_reclaimer_stats();
+      ::taxon::defer_destroy(::std::move(val));
+      assert(val.is_null());
+      ::taxon::defer_destroy(::taxon::Value(42));
+      ::taxon::flush_deferred();
+
+      auto stats2 = ::taxon::get_reclaimer_stats();
+      assert(stats2.queue_depth == 0);
+      assert(stats2.reclaimed_values == stats.reclaimed_values + 1);
+      assert(stats2.reclaimed_nodes == stats.reclaimed_nodes + 3001);
+    }
+
+    {
+      // teardown without allocation
+      ::taxon::Value shared;
+      shared.open_object().try_emplace(&"x").first->second.open_array().emplace_back(1);
+      ::std::size_t count;
+      {
+        ::taxon::Value val;
+        auto pval = &val;
+        for(int k = 0;  k != 100000;  ++k) {
+          auto& obj = pval->open_object();
+          obj.try_emplace(&"a", shared);
+          obj.try_emplace(&"b").first->second.open_array().emplace_back(2);
+          obj.try_emplace(&"c", &"hello");
+          pval = &(obj.try_emplace(&"d").first->second.open_array().emplace_back());
+        }
+        count = ::new_count;
+      }
+      assert(::new_count == count);
+      assert(shared.as_object().at(&"x").as_array().size() == 1);
+    }
+
+    {
+      // reusable parser
+      static constexpr char text[] = R"({"id":42,"name":"hello","tags":["a","b"],"meta":{"ok":true}})";
+      ::taxon::Value val;
+      ::std::size_t count = ::new_count;
+      assert(val.parse(text));
+      ::std::size_t fresh = ::new_count - count;
+
+      ::taxon::Parser parser;
+      assert(parser.parse(val, text));
+      assert(parser.parse(val, text));
+      count = ::new_count;
+      assert(parser.parse(val, text));
+      assert(::new_count - count < fresh);
+      assert(val.as_object().at(&"meta").as_object().at(&"ok").as_boolean());
+
+      ::taxon::Parser_Context ctx;
+      parser.parse_with(val, ctx, "[1,", 3);
+      assert(::std::strcmp(ctx.error, "Missing value") == 0);
+      assert(parser.parse(val, &"[[[1]]]"));
+      assert(val.to_string() == "[[[1]]]");
+      parser.clear();
+      assert(parser.parse(val, text, sizeof(text) - 1));
+    }
+
+    {
+      // key dictionary
+      ::taxon::Key_Dictionary dict;
+      ::taxon::Parser first(&dict), second(&dict);
+      ::taxon::Value val;
+      assert(first.parse(val, &R"({"id":1,"name":"a","meta":{"id":2}})"));
+      assert(dict.size() == 3);
+      assert(second.parse(val, &R"({"id":3,"extra":[{"name":"b"}]})"));
+      assert(dict.size() == 4);
+      assert(val.as_object().at(&"extra").as_array().at(0).as_object().at(&"name").as_string() == "b");
+      assert(dict.intern("id", 2).rdstr() == "id");
+
+      ::taxon::Key_Dictionary small(2, false);
+      ::taxon::Parser third(&small);
+      assert(third.parse(val, &R"({"a":1,"b":2,"c":{"d":3}})"));
+      assert(small.size() == 2);
+      assert(val.as_object().at(&"c").as_object().at(&"d").as_number() == 3);
+      small.clear();
+      assert(small.size() == 0);
+
+      ::asteria::cow_string docs[2] = { &R"({"id":4,"tag":1})", &R"({"tag":2,"more":3})" };
+      ::taxon::V_array values;
+      ::std::vector<::taxon::Parser_Context> contexts;
+      assert(::taxon::parse_batch(values, contexts, docs, 2, 2, ::taxon::options_default, &dict));
+      assert(dict.size() == 6);
+
+      ::taxon::Key_Dictionary unsafe(16, false);
+      try {
+        ::taxon::parse_batch(values, contexts, docs, 2, 2, ::taxon::options_default, &unsafe);
+        assert(false);
+      }
+      catch(::std::invalid_argument&) { }
+      assert(unsafe.size() == 0);
+      assert(::taxon::parse_batch(values, contexts, docs, 2, 1, ::taxon::options_default, &unsafe));
+      assert(unsafe.size() == 3);
+      assert(values.at(1).as_object().at(&"more").as_number() == 3);
+    }
+
+    {
+      // key pool with many keys
+      ::asteria::cow_string str = &"[";
+      for(int r = 0;  r != 3;  ++r) {
+        str += "{";
+        for(int k = 0;  k != 3000;  ++k) {
+          str += "\"key";
+          str += ::std::to_string(k).c_str();
+          str += "\":";
+          str += ::std::to_string(k + r).c_str();
+          str += ",";
+        }
+        str += "\"\":null},";
+      }
+      str += "{}]";
+
+      ::taxon::Value val;
+      assert(val.parse(str));
+      assert(val.as_array().size() == 4);
+      for(int r = 0;  r != 3;  ++r) {
+        const auto& obj = val.as_array().at(static_cast<::std::size_t>(r)).as_object();
+        assert(obj.size() == 3001);
+        assert(obj.at(&"key2999").as_number() == 2999 + r);
+        assert(obj.at(&"").is_null());
+      }
+    }
+
+    {
+      // object shapes
+      static constexpr char text[] =
+          R"([{"id":1,"name":"a","tags":{"x":1}},{"id":2,"name":"b","tags":{"y":2}},)"
+          R"({"id":3,"tags":{},"name":"c","more":true},{"id":4},{"id":5,"name":"e"}])";
+      ::taxon::Value val;
+      assert(val.parse(text));
+      const auto& arr = val.as_array();
+      assert(arr.size() == 5);
+      assert(arr.at(1).as_object().at(&"tags").as_object().at(&"y").as_number() == 2);
+      assert(arr.at(2).as_object().size() == 4);
+      assert(arr.at(2).as_object().at(&"name").as_string() == "c");
+      assert(arr.at(3).as_object().size() == 1);
+      assert(arr.at(4).as_object().at(&"name").as_string() == "e");
+
+      ::taxon::Parser_Context ctx;
+      val.parse_with(ctx, &R"([{"a":1,"b":2},{"a":1,"a":2}])");
+      assert(::std::strcmp(ctx.error, "Duplicate key string") == 0);
+      assert(ctx.offset == 22);
+    }
+
+    {
+      // structural index in windows
+      ::asteria::cow_string str = &"[\"";
+      str.append(200000, 'a');
+      str += "\",";
+      for(int k = 0;  k != 30000;  ++k)
+        str += "[12345,\"\\\"]\",{\"k\":true}],";
+      str += "[]]";
+
+      ::taxon::Value val;
+      assert(val.parse(str));
+      assert(val.as_array().size() == 30002);
+      assert(val.as_array().at(0).as_string().size() == 200000);
+      assert(val.as_array().at(30000).as_array().at(1).as_string() == "\"]");
+      assert(val.as_array().at(30000).as_array().capacity() == 3);
+      assert(::taxon::validate(str.data(), str.size()));
+    }
+
+    {
+      // exact capacities
+      static constexpr char text[] =
+          R"([[1,2,3],[],{"a":[1,2,[3,4],5],"b":{},"c":[[]]},[[1],[2,3]],"x,y]",{"d":"}"}])";
+      ::taxon::Value val;
+      assert(val.parse(text));
+      const auto& arr = val.as_array();
+      assert(arr.size() == 6);
+      assert(arr.at(0).as_array().size() == 3);
+      assert(arr.at(1).as_array().size() == 0);
+      assert(arr.at(2).as_object().size() == 3);
+      assert(arr.at(2).as_object().at(&"a").as_array().size() == 4);
+      assert(arr.at(2).as_object().at(&"c").as_array().at(0).as_array().size() == 0);
+      assert(arr.at(3).as_array().at(1).as_array().size() == 2);
+      assert(arr.at(4).as_string() == "x,y]");
+      assert(arr.at(5).as_object().at(&"d").as_string() == "}");
+
+      auto check_capacities = [](const ::taxon::Value& root)
+        {
+          ::std::vector<const ::taxon::Value*> stack = { &root };
+          while(!stack.empty()) {
+            const ::taxon::Value* pval = stack.back();
+            stack.pop_back();
+            if(pval->is_array()) {
+              assert(pval->as_array().capacity() == pval->as_array().size());
+              for(const auto& elem : pval->as_array())
+                stack.push_back(&elem);
+            }
+            else if(pval->is_object()) {
+              assert(pval->as_object().capacity() == pval->as_object().size());
+              for(const auto& pair : pval->as_object())
+                stack.push_back(&(pair.second));
+            }
+          }
+        };
+
+      check_capacities(val);
+
+      ::asteria::cow_string str = &"[";
+      for(int k = 0;  k != 40000;  ++k) {
+        str += "{\"id\":";
+        str += ::std::to_string(k).c_str();
+        str += ",\"tags\":[1,2,3,4,5,6,7]},";
+      }
+      str += "{}]";
+
+      ::taxon::Value big;
+      assert(big.parse_parallel(str.data(), str.size(), 4));
+      assert(big.as_array().size() == 40001);
+      assert(big.as_array().at(39999).as_object().at(&"id").as_number() == 39999);
+      check_capacities(big);
+
+      ::taxon::V_array shared = arr.at(0).as_array();
+      ::taxon::V_array grown;
+      for(int k = 0;  k != 100;  ++k)
+        grown.emplace_back(k);
+      grown.emplace_back(shared);
+      val.open_array().emplace_back(grown);
+      val.shrink_to_fit();
+      assert(val.as_array().size() == 7);
+      assert(val.as_array().at(6).as_array().size() == 101);
+      assert(val.as_array().at(0).as_array().data() == shared.data());
+    }
+
+    {
+      // fast number decoding
+      static constexpr char text[] =
+          R"([0,-0,12.5,0.1,-1.25e-3,123456789012345678,1e22,1e23,0.000000000000000000001,)"
+          R"("$l:123456789012345678","$l:-1234567890123456789","$l:0x10","$l:007","$d:2.5",)"
+          R"("$t:1700000000123","$t:-2208988800000","$d:1e400"])";
+      ::taxon::Value val;
+      assert(val.parse(text));
+      const auto& arr = val.as_array();
+      assert(arr.size() == 17);
+      assert(arr.at(0).as_number() == 0 && !::std::signbit(arr.at(0).as_number()));
+      assert(arr.at(1).as_number() == 0 && ::std::signbit(arr.at(1).as_number()));
+      assert(arr.at(2).as_number() == 12.5);
+      assert(arr.at(3).as_number() == 0.1);
+      assert(arr.at(4).as_number() == -1.25e-3);
+      assert(arr.at(5).as_number() == 123456789012345678.0);
+      assert(arr.at(6).as_number() == 1e22);
+      assert(arr.at(7).as_number() == 1e23);
+      assert(arr.at(8).as_number() == 1e-21);
+      assert(arr.at(9).as_integer() == 123456789012345678);
+      assert(arr.at(10).as_integer() == -1234567890123456789);
+      assert(arr.at(11).as_integer() == 16);
+      assert(arr.at(12).as_integer() == 7);
+      assert(arr.at(13).as_number() == 2.5);
+      assert(::std::chrono::time_point_cast<::std::chrono::milliseconds>(
+                 arr.at(14).as_time()).time_since_epoch().count() == 1700000000123);
+      assert(::std::chrono::time_point_cast<::std::chrono::milliseconds>(
+                 arr.at(15).as_time()).time_since_epoch().count() == -2208988800000);
+      assert(::std::isinf(arr.at(16).as_number()));
+
+      ::taxon::Parser_Context ctx;
+      val.parse_with(ctx, &R"("$t:-2208988800001")");
+      assert(::std::strcmp(ctx.error, "Timestamp value out of range") == 0);
+      val.parse_with(ctx, &R"("$l:12a")");
+      assert(::std::strcmp(ctx.error, "Invalid 64-bit integer") == 0);
+    }
+
+    {
+      // long significands and large exponents
+      static constexpr char text[] =
+          R"([0.30000000000000004,0.00011911560612140261,9007199254740993,9007199254740995,)"
+          R"(1.7976931348623157e308,2.2250738585072014e-308,4.9e-324,1.8e-323,1e-300,)"
+          R"(-8.98846567431158e307,123456789.12345678e-310,1e-400,"$d:1.7976931348623159e308"])";
+      ::taxon::Value val;
+      assert(val.parse(text));
+      const auto& arr = val.as_array();
+      assert(arr.size() == 13);
+      assert(arr.at(0).as_number() == 0.1 + 0.2);
+      assert(arr.at(1).as_number() == 0.00011911560612140261);
+      assert(arr.at(2).as_number() == 9007199254740992.0);
+      assert(arr.at(3).as_number() == 9007199254740996.0);
+      assert(arr.at(4).as_number() == DBL_MAX);
+      assert(arr.at(5).as_number() == DBL_MIN);
+      assert(arr.at(6).as_number() == DBL_TRUE_MIN);
+      assert(arr.at(7).as_number() == DBL_TRUE_MIN * 4);
+      assert(arr.at(8).as_number() == 1e-300);
+      assert(arr.at(9).as_number() == -8.98846567431158e307);
+      assert(arr.at(10).as_number() == 123456789.12345678e-310);
+      assert(arr.at(11).as_number() == 0);
+      assert(::std::isinf(arr.at(12).as_number()));
+
+      // Shortest representations of doubles must round-trip.
+      uint64_t seed = 1;
+      for(int k = 0;  k != 100000;  ++k) {
+        seed = seed * 6364136223846793005 + 1442695040888963407;
+        double num = ::std::ldexp(static_cast<double>(seed >> 11), static_cast<int>(seed % 2000) - 1100);
+        ::taxon::Value in = num;
+        ::taxon::Value out;
+        assert(out.parse(in.to_string()));
+        assert(out.as_number() == num);
+      }
+    }
+
     // leak check
     assert(::alloc_count == 0);
   }